@@ -0,0 +1,84 @@
+#pragma once
+#include "vector.h"
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+inline constexpr size_t CACHE_LINE_SIZE = 64;
+inline constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+// Аллокатор, выравнивающий начало буфера по границе Alignment байт
+// (по умолчанию - по строке кэша) с помощью выравнивающего operator new.
+// Буферы размером не меньше HugePageThreshold байт выравниваются по границе
+// страницы 2 МБ и на Linux помечаются MADV_HUGEPAGE, чтобы ядро отображало их
+// прозрачными большими страницами. Нулевой порог отключает большие страницы
+template <typename T, size_t Alignment = CACHE_LINE_SIZE, size_t HugePageThreshold = 0>
+class AlignedAllocator {
+    static_assert(Alignment != 0 && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    static constexpr size_t ALIGNMENT = Alignment > alignof(T) ? Alignment : alignof(T);
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment, HugePageThreshold>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment, HugePageThreshold>&) noexcept {}
+
+    T* allocate(size_t n){
+        if(n > std::numeric_limits<size_t>::max() / sizeof(T)){
+            throw std::bad_array_new_length();
+        }
+        const size_t bytes = n * sizeof(T);
+        if(UseHugePages(bytes)){
+            // Размер округляется до целого числа больших страниц
+            const size_t rounded = (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+            void* buffer = operator new(rounded, std::align_val_t{HUGE_PAGE_SIZE});
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+            // Это лишь подсказка ядру, ошибку можно игнорировать
+            madvise(buffer, rounded, MADV_HUGEPAGE);
+#endif
+            return static_cast<T*>(buffer);
+        }
+        return static_cast<T*>(operator new(bytes, std::align_val_t{ALIGNMENT}));
+    }
+
+    void deallocate(T* buffer, size_t n) noexcept {
+        const size_t bytes = n * sizeof(T);
+        operator delete(buffer, std::align_val_t{UseHugePages(bytes) ? HUGE_PAGE_SIZE : ALIGNMENT});
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment, HugePageThreshold>&) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment, HugePageThreshold>&) const noexcept {
+        return false;
+    }
+
+private:
+    static constexpr bool UseHugePages(size_t bytes) noexcept {
+        return HugePageThreshold != 0 && bytes >= HugePageThreshold;
+    }
+};
+
+template <typename T, size_t Alignment = CACHE_LINE_SIZE>
+using AlignedVector = Vector<T, AlignedAllocator<T, Alignment>>;
+
+// Вектор для очень больших массивов: буферы от 2 МБ размещаются в больших страницах
+template <typename T>
+using HugePageVector = Vector<T, AlignedAllocator<T, CACHE_LINE_SIZE, HUGE_PAGE_SIZE>>;
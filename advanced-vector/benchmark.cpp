@@ -0,0 +1,679 @@
+// Сравнение производительности Vector и std::vector на основе Google Benchmark.
+//
+// Сборка:  g++ -std=c++17 -O2 -DNDEBUG benchmark.cpp -lbenchmark -lpthread -o benchmark
+// Запуск:  ./benchmark [--max_size=N] [--perf_counters] [параметры Google Benchmark]
+// JSON:    ./benchmark --perf_counters --benchmark_out=result.json --benchmark_out_format=json
+//
+// Каждый сценарий регистрируется парой «std::vector» / «Vector» для одного и того же
+// типа элемента и размера, поэтому в отчёте результаты идут рядом. Поиск
+// в FlatMap сравнивается так же с поиском в std::map.
+// --max_size ограничивает число элементов (по умолчанию 10^6, допустимо до 10^8);
+// квадратичные сценарии (вставка и удаление в начале и середине) ограничены 10^5.
+// --perf_counters (только Linux) добавляет к каждому сценарию счётчики perf_event_open
+// в пересчёте на итерацию: такты, инструкции, промахи L1D и LLC, промахи
+// предсказания ветвлений и страничные отказы. Они попадают в JSON-отчёт Google Benchmark
+// вместе со временем и подходят для сравнения между коммитами
+
+#include "flat_containers.h"
+#include "vector.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr size_t DEFAULT_MAX_SIZE = 1'000'000;
+constexpr size_t MAX_QUADRATIC_SIZE = 100'000;
+// Количество различных значений, циклически вставляемых в контейнер
+constexpr size_t NUM_SAMPLE_VALUES = 64;
+
+struct Pod64 {
+    int64_t values[8];
+};
+
+// Аналог Obj из тестов: копирование может бросить исключение, а перемещение
+// не помечено noexcept, поэтому при реаллокации оба вектора копируют элементы
+struct ThrowingCopy {
+    explicit ThrowingCopy(int id)
+        : id(id) {
+    }
+
+    ThrowingCopy(const ThrowingCopy& other)
+        : id(other.id)
+        , throw_on_copy(other.throw_on_copy) {
+        if(throw_on_copy){
+            throw std::runtime_error("Oops");
+        }
+    }
+
+    ThrowingCopy(ThrowingCopy&& other) noexcept(false) = default;
+    ThrowingCopy& operator=(const ThrowingCopy& other) = default;
+    ThrowingCopy& operator=(ThrowingCopy&& other) = default;
+
+    int id = 0;
+    bool throw_on_copy = false;
+};
+
+// Строка, считающая вызовы конструкторов и операторов присваивания. Нужна, чтобы
+// показать в отчёте число перемещений тяжёлых элементов на одну вставку
+struct CountedString {
+    explicit CountedString(std::string value)
+        : value(std::move(value)) {
+    }
+
+    CountedString(const CountedString& other)
+        : value(other.value) {
+        ++copies;
+    }
+
+    CountedString(CountedString&& other) noexcept
+        : value(std::move(other.value)) {
+        ++moves;
+    }
+
+    CountedString& operator=(const CountedString& other) {
+        value = other.value;
+        ++copies;
+        return *this;
+    }
+
+    CountedString& operator=(CountedString&& other) noexcept {
+        value = std::move(other.value);
+        ++moves;
+        return *this;
+    }
+
+    static void ResetCounters() {
+        copies = 0;
+        moves = 0;
+    }
+
+    std::string value;
+
+    inline static size_t copies = 0;
+    inline static size_t moves = 0;
+};
+
+template <typename T>
+T MakeValue(size_t i);
+
+template <>
+int MakeValue<int>(size_t i) {
+    return static_cast<int>(i);
+}
+
+template <>
+std::string MakeValue<std::string>(size_t i) {
+    // Строка длиннее буфера small string optimization
+    return std::string(32, static_cast<char>('a' + i % 26));
+}
+
+template <>
+Pod64 MakeValue<Pod64>(size_t i) {
+    Pod64 value{};
+    value.values[0] = static_cast<int64_t>(i);
+    return value;
+}
+
+template <>
+ThrowingCopy MakeValue<ThrowingCopy>(size_t i) {
+    return ThrowingCopy(static_cast<int>(i));
+}
+
+template <>
+CountedString MakeValue<CountedString>(size_t i) {
+    return CountedString(MakeValue<std::string>(i));
+}
+
+template <typename T>
+std::vector<T> MakeSampleValues() {
+    std::vector<T> values;
+    values.reserve(NUM_SAMPLE_VALUES);
+    for(size_t i = 0; i < NUM_SAMPLE_VALUES; ++i){
+        values.push_back(MakeValue<T>(i));
+    }
+    return values;
+}
+
+size_t Touch(int value) {
+    return static_cast<size_t>(value);
+}
+
+size_t Touch(const std::string& value) {
+    return value.size();
+}
+
+size_t Touch(const Pod64& value) {
+    return static_cast<size_t>(value.values[0]);
+}
+
+size_t Touch(const ThrowingCopy& value) {
+    return static_cast<size_t>(value.id);
+}
+
+// Единый интерфейс к сравниваемым контейнерам
+template <typename Container>
+struct Api;
+
+template <typename T>
+struct Api<std::vector<T>> {
+    using Container = std::vector<T>;
+
+    static void PushBack(Container& c, const T& value) {
+        c.push_back(value);
+    }
+
+    template <typename... Args>
+    static void EmplaceBack(Container& c, Args&&... args) {
+        c.emplace_back(std::forward<Args>(args)...);
+    }
+
+    static void Insert(Container& c, size_t index, const T& value) {
+        c.insert(c.begin() + index, value);
+    }
+
+    static void Erase(Container& c, size_t index) {
+        c.erase(c.begin() + index);
+    }
+
+    static void Reserve(Container& c, size_t capacity) {
+        c.reserve(capacity);
+    }
+
+    static size_t Size(const Container& c) {
+        return c.size();
+    }
+
+    static const T* Data(const Container& c) {
+        return c.data();
+    }
+};
+
+template <typename T>
+struct Api<Vector<T>> {
+    using Container = Vector<T>;
+
+    static void PushBack(Container& c, const T& value) {
+        c.PushBack(value);
+    }
+
+    template <typename... Args>
+    static void EmplaceBack(Container& c, Args&&... args) {
+        c.EmplaceBack(std::forward<Args>(args)...);
+    }
+
+    static void Insert(Container& c, size_t index, const T& value) {
+        c.Insert(c.cbegin() + index, value);
+    }
+
+    static void Erase(Container& c, size_t index) {
+        c.Erase(c.cbegin() + index);
+    }
+
+    static void Reserve(Container& c, size_t capacity) {
+        c.Reserve(capacity);
+    }
+
+    static size_t Size(const Container& c) {
+        return c.Size();
+    }
+
+    static const T* Data(const Container& c) {
+        return c.begin();
+    }
+};
+
+template <typename Container>
+Container MakeContainer(size_t size) {
+    using T = typename Container::value_type;
+    const auto values = MakeSampleValues<T>();
+    Container c;
+    Api<Container>::Reserve(c, size);
+    for(size_t i = 0; i < size; ++i){
+        Api<Container>::PushBack(c, values[i % NUM_SAMPLE_VALUES]);
+    }
+    return c;
+}
+
+template <typename Container>
+void BM_PushBack(benchmark::State& state) {
+    using T = typename Container::value_type;
+    const size_t size = state.range(0);
+    const auto values = MakeSampleValues<T>();
+    for(auto _ : state){
+        Container c;
+        for(size_t i = 0; i < size; ++i){
+            Api<Container>::PushBack(c, values[i % NUM_SAMPLE_VALUES]);
+        }
+        benchmark::DoNotOptimize(Api<Container>::Data(c));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Container>
+void BM_EmplaceBack(benchmark::State& state) {
+    using T = typename Container::value_type;
+    const size_t size = state.range(0);
+    for(auto _ : state){
+        Container c;
+        for(size_t i = 0; i < size; ++i){
+            Api<Container>::EmplaceBack(c, MakeValue<T>(i));
+        }
+        benchmark::DoNotOptimize(Api<Container>::Data(c));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Container>
+void BM_ReservePushBack(benchmark::State& state) {
+    using T = typename Container::value_type;
+    const size_t size = state.range(0);
+    const auto values = MakeSampleValues<T>();
+    for(auto _ : state){
+        Container c;
+        Api<Container>::Reserve(c, size);
+        for(size_t i = 0; i < size; ++i){
+            Api<Container>::PushBack(c, values[i % NUM_SAMPLE_VALUES]);
+        }
+        benchmark::DoNotOptimize(Api<Container>::Data(c));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+enum class Position {
+    FRONT,
+    MIDDLE,
+    BACK
+};
+
+size_t IndexAt(Position position, size_t size) {
+    switch(position){
+    case Position::FRONT:
+        return 0;
+    case Position::MIDDLE:
+        return size / 2;
+    case Position::BACK:
+        return size;
+    }
+    return size;
+}
+
+template <typename Container, Position position>
+void BM_Insert(benchmark::State& state) {
+    using T = typename Container::value_type;
+    const size_t size = state.range(0);
+    const auto values = MakeSampleValues<T>();
+    for(auto _ : state){
+        Container c;
+        for(size_t i = 0; i < size; ++i){
+            Api<Container>::Insert(c, IndexAt(position, Api<Container>::Size(c)), values[i % NUM_SAMPLE_VALUES]);
+        }
+        benchmark::DoNotOptimize(Api<Container>::Data(c));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Container, Position position>
+void BM_Erase(benchmark::State& state) {
+    const size_t size = state.range(0);
+    for(auto _ : state){
+        state.PauseTiming();
+        Container c = MakeContainer<Container>(size);
+        state.ResumeTiming();
+        while(Api<Container>::Size(c) != 0){
+            const size_t index = std::min(IndexAt(position, Api<Container>::Size(c)), Api<Container>::Size(c) - 1);
+            Api<Container>::Erase(c, index);
+        }
+        benchmark::DoNotOptimize(Api<Container>::Data(c));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+// Вставка в середину заранее зарезервированного контейнера: реаллокаций нет,
+// поэтому счётчики показывают только сдвиг элементов и промежуточные копии.
+// Счётчики copies/insert и moves/insert не зависят от времени выполнения
+template <typename Container>
+void BM_InsertMiddleCounted(benchmark::State& state) {
+    const size_t size = state.range(0);
+    const auto values = MakeSampleValues<CountedString>();
+    size_t copies = 0;
+    size_t moves = 0;
+    for(auto _ : state){
+        Container c;
+        Api<Container>::Reserve(c, size);
+        CountedString::ResetCounters();
+        for(size_t i = 0; i < size; ++i){
+            Api<Container>::Insert(c, Api<Container>::Size(c) / 2, values[i % NUM_SAMPLE_VALUES]);
+        }
+        copies += CountedString::copies;
+        moves += CountedString::moves;
+        benchmark::DoNotOptimize(Api<Container>::Data(c));
+        benchmark::ClobberMemory();
+    }
+    const double inserts = static_cast<double>(state.iterations() * size);
+    state.counters["copies/insert"] = static_cast<double>(copies) / inserts;
+    state.counters["moves/insert"] = static_cast<double>(moves) / inserts;
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Container>
+void BM_CopyAssign(benchmark::State& state) {
+    const size_t size = state.range(0);
+    const Container source = MakeContainer<Container>(size);
+    for(auto _ : state){
+        Container c;
+        c = source;
+        benchmark::DoNotOptimize(Api<Container>::Data(c));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Container>
+void BM_MoveAssign(benchmark::State& state) {
+    const size_t size = state.range(0);
+    Container source = MakeContainer<Container>(size);
+    Container target;
+    for(auto _ : state){
+        target = std::move(source);
+        source = std::move(target);
+        benchmark::DoNotOptimize(Api<Container>::Data(source));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+template <typename Container>
+void BM_Iterate(benchmark::State& state) {
+    const size_t size = state.range(0);
+    const Container c = MakeContainer<Container>(size);
+    for(auto _ : state){
+        size_t sum = 0;
+        for(const auto& value : c){
+            sum += Touch(value);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+// Поиск случайных ключей, половина которых есть в таблице
+template <typename Map>
+void BM_Lookup(benchmark::State& state) {
+    const size_t size = state.range(0);
+    Map map;
+    for(size_t i = 0; i < size; ++i){
+        map[static_cast<int>(i * 2)] = static_cast<int>(i);
+    }
+    std::mt19937 generator(42);
+    std::vector<int> keys(4096);
+    for(int& key : keys){
+        key = static_cast<int>(generator() % (size * 2));
+    }
+    size_t i = 0;
+    for(auto _ : state){
+        const int key = keys[i++ % keys.size()];
+        benchmark::DoNotOptimize(map.find(key) != map.end());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Адаптер FlatMap к интерфейсу std::map, достаточному для BM_Lookup
+struct FlatMapAdapter : FlatMap<int, int> {
+    auto find(int key) const {
+        return Find(key);
+    }
+
+    auto end() const {
+        return FlatMap<int, int>::end();
+    }
+};
+
+#if defined(__linux__)
+struct PerfEvent {
+    const char* name;
+    uint32_t type;
+    uint64_t config;
+};
+
+constexpr uint64_t CacheReadMisses(uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+constexpr PerfEvent PERF_EVENTS[] = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"L1D-misses", PERF_TYPE_HW_CACHE, CacheReadMisses(PERF_COUNT_HW_CACHE_L1D)},
+    {"LLC-misses", PERF_TYPE_HW_CACHE, CacheReadMisses(PERF_COUNT_HW_CACHE_LL)},
+    {"branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {"page-faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+};
+#endif
+
+// Счётчики perf_event_open текущего потока, считающие только пользовательский режим.
+// События открываются по отдельности: недоступные на этой машине или запрещённые
+// kernel.perf_event_paranoid пропускаются, остальные продолжают работать
+class PerfCounters {
+public:
+    PerfCounters() {
+#if defined(__linux__)
+        for(const PerfEvent& event : PERF_EVENTS){
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = event.type;
+            attr.config = event.config;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            if(fd >= 0){
+                opened_.push_back({event.name, fd});
+            }
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for(const Opened& counter : opened_){
+            close(counter.fd);
+        }
+#endif
+    }
+
+    bool IsEmpty() const {
+        return opened_.empty();
+    }
+
+    void Start() {
+#if defined(__linux__)
+        for(const Opened& counter : opened_){
+            ioctl(counter.fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(counter.fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // Значения с начала Start(). Если ядро мультиплексировало счётчики,
+    // значение экстраполируется на всё время измерения
+    std::vector<std::pair<const char*, double>> Stop() {
+        std::vector<std::pair<const char*, double>> values;
+#if defined(__linux__)
+        for(const Opened& counter : opened_){
+            ioctl(counter.fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+        for(const Opened& counter : opened_){
+            // value, time_enabled, time_running
+            uint64_t data[3] = {};
+            if(read(counter.fd, data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0){
+                continue;
+            }
+            values.emplace_back(counter.name, static_cast<double>(data[0]) * data[1] / data[2]);
+        }
+#endif
+        return values;
+    }
+
+private:
+    struct Opened {
+        const char* name;
+        int fd;
+    };
+
+    std::vector<Opened> opened_;
+};
+
+// Регистрирует сценарий. В режиме perf_counters счётчики охватывают весь вызов
+// функции сценария, включая подготовку данных вне замера времени
+template <typename Function>
+benchmark::internal::Benchmark* RegisterScenario(const std::string& name, Function function, bool perf_counters) {
+    if(!perf_counters){
+        return benchmark::RegisterBenchmark(name.c_str(), function);
+    }
+    return benchmark::RegisterBenchmark(name.c_str(), [function](benchmark::State& state) {
+        PerfCounters counters;
+        counters.Start();
+        function(state);
+        for(const auto& [counter, value] : counters.Stop()){
+            state.counters[counter] = benchmark::Counter(value, benchmark::Counter::kAvgIterations);
+        }
+    });
+}
+
+void ApplySizes(benchmark::internal::Benchmark* benchmark, size_t max_size) {
+    for(size_t size = 1; size <= max_size; size *= 10){
+        benchmark->Arg(static_cast<int64_t>(size));
+    }
+}
+
+struct Options {
+    size_t max_size = DEFAULT_MAX_SIZE;
+    bool perf_counters = false;
+};
+
+class Registrar {
+public:
+    Registrar(std::string type_name, const Options& options)
+        : type_name_(std::move(type_name))
+        , max_size_(options.max_size)
+        , perf_counters_(options.perf_counters) {
+    }
+
+    template <typename StdBenchmark, typename VectorBenchmark>
+    void Register(std::string_view scenario, StdBenchmark std_benchmark, VectorBenchmark vector_benchmark,
+                  bool quadratic = false) const {
+        const size_t max_size = quadratic ? std::min(max_size_, MAX_QUADRATIC_SIZE) : max_size_;
+        const std::string prefix = std::string(scenario) + "/" + type_name_ + "/";
+        ApplySizes(RegisterScenario(prefix + "std::vector", std_benchmark, perf_counters_), max_size);
+        ApplySizes(RegisterScenario(prefix + "Vector", vector_benchmark, perf_counters_), max_size);
+    }
+
+private:
+    std::string type_name_;
+    size_t max_size_;
+    bool perf_counters_;
+};
+
+template <typename T>
+void RegisterScenarios(const std::string& type_name, const Options& options) {
+    using Std = std::vector<T>;
+    using Our = Vector<T>;
+    const Registrar r(type_name, options);
+    r.Register("PushBack", BM_PushBack<Std>, BM_PushBack<Our>);
+    r.Register("EmplaceBack", BM_EmplaceBack<Std>, BM_EmplaceBack<Our>);
+    r.Register("ReservePushBack", BM_ReservePushBack<Std>, BM_ReservePushBack<Our>);
+    r.Register("InsertFront", BM_Insert<Std, Position::FRONT>, BM_Insert<Our, Position::FRONT>, true);
+    r.Register("InsertMiddle", BM_Insert<Std, Position::MIDDLE>, BM_Insert<Our, Position::MIDDLE>, true);
+    r.Register("InsertBack", BM_Insert<Std, Position::BACK>, BM_Insert<Our, Position::BACK>);
+    r.Register("EraseFront", BM_Erase<Std, Position::FRONT>, BM_Erase<Our, Position::FRONT>, true);
+    r.Register("EraseMiddle", BM_Erase<Std, Position::MIDDLE>, BM_Erase<Our, Position::MIDDLE>, true);
+    r.Register("EraseBack", BM_Erase<Std, Position::BACK>, BM_Erase<Our, Position::BACK>);
+    r.Register("CopyAssign", BM_CopyAssign<Std>, BM_CopyAssign<Our>);
+    r.Register("MoveAssign", BM_MoveAssign<Std>, BM_MoveAssign<Our>);
+    r.Register("Iterate", BM_Iterate<Std>, BM_Iterate<Our>);
+}
+
+void RegisterCountedScenarios(const Options& options) {
+    const Registrar r("CountedString", options);
+    r.Register("InsertMiddleCounted", BM_InsertMiddleCounted<std::vector<CountedString>>,
+               BM_InsertMiddleCounted<Vector<CountedString>>, true);
+}
+
+void RegisterLookupScenarios(const Options& options) {
+    ApplySizes(RegisterScenario("Lookup/int/std::map", BM_Lookup<std::map<int, int>>, options.perf_counters),
+               options.max_size);
+    ApplySizes(RegisterScenario("Lookup/int/FlatMap", BM_Lookup<FlatMapAdapter>, options.perf_counters),
+               options.max_size);
+}
+
+// Извлекает из командной строки собственные параметры --max_size=N и --perf_counters,
+// остальные параметры передаются Google Benchmark
+Options ParseOptions(int& argc, char** argv) {
+    constexpr std::string_view MAX_SIZE_FLAG = "--max_size=";
+    constexpr std::string_view PERF_COUNTERS_FLAG = "--perf_counters";
+    Options options;
+    int out = 1;
+    for(int i = 1; i < argc; ++i){
+        const std::string_view arg = argv[i];
+        if(arg.substr(0, MAX_SIZE_FLAG.size()) == MAX_SIZE_FLAG){
+            options.max_size = std::strtoull(argv[i] + MAX_SIZE_FLAG.size(), nullptr, 10);
+        } else if(arg == PERF_COUNTERS_FLAG){
+            options.perf_counters = true;
+        } else {
+            argv[out++] = argv[i];
+        }
+    }
+    argc = out;
+    return options;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const Options options = ParseOptions(argc, argv);
+    if(options.perf_counters && PerfCounters().IsEmpty()){
+        std::cerr << "perf_event_open is unavailable, hardware counters will not be reported" << std::endl;
+    }
+
+    RegisterScenarios<int>("int", options);
+    RegisterScenarios<std::string>("string", options);
+    RegisterScenarios<Pod64>("Pod64", options);
+    RegisterScenarios<ThrowingCopy>("ThrowingCopy", options);
+    RegisterCountedScenarios(options);
+    RegisterLookupScenarios(options);
+
+    benchmark::Initialize(&argc, argv);
+    if(benchmark::ReportUnrecognizedArguments(argc, argv)){
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
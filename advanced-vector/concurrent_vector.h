@@ -0,0 +1,198 @@
+#pragma once
+#include "aligned_allocator.h"
+#include "segmented_vector.h"
+#include "vector.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Вектор, в который могут одновременно добавлять элементы несколько потоков.
+// Элементы хранятся в сегментах GeometricSegments и никогда не перемещаются, поэтому ссылки на них
+// остаются действительными. Добавление не блокирует потоки: место под элемент
+// занимается CAS, а новые сегменты подставляются CAS в таблицу сегментов.
+// Size() считает опубликованные элементы: все элементы с индексами меньше Size()
+// построены и видны читающему потоку
+template <typename T>
+class ConcurrentVector {
+    static_assert(std::is_nothrow_move_constructible_v<T>, "ConcurrentVector requires a nothrow move constructor");
+    using Segments = GeometricSegments<5>;
+public:
+    using value_type = T;
+
+    ConcurrentVector() noexcept = default;
+
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+    ~ConcurrentVector(){
+        Destroy();
+    }
+
+    size_t Size() const noexcept {
+        return published_.load(std::memory_order_acquire);
+    }
+
+    // Заранее выделяет сегменты под capacity элементов
+    void Reserve(size_t capacity){
+        for(size_t segment = 0; Segments::Start(segment) < capacity; ++segment){
+            GetSegment(segment);
+        }
+    }
+
+    void PushBack(const T& value){
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value){
+        EmplaceBack(std::move(value));
+    }
+
+    // Безопасно вызывать из нескольких потоков одновременно. Возвращённая ссылка
+    // действительна до разрушения вектора
+    template <typename... Args>
+    T& EmplaceBack(Args&&... ctor_args){
+        if constexpr(std::is_nothrow_constructible_v<T, Args...>){
+            const size_t index = ReserveSlot();
+            T* const element = new (Slot(index)) T(std::forward<Args>(ctor_args)...);
+            Publish(index);
+            return *element;
+        } else {
+            // Место занимается только после построения элемента, чтобы исключение
+            // не оставило в векторе незаполненную ячейку
+            T value(std::forward<Args>(ctor_args)...);
+            const size_t index = ReserveSlot();
+            T* const element = new (Slot(index)) T(std::move(value));
+            Publish(index);
+            return *element;
+        }
+    }
+
+    // index должен быть меньше Size()
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<ConcurrentVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < Size());
+        return *Slot(index);
+    }
+
+    // Переносит элементы в непрерывный Vector и очищает *this.
+    // Вызывается, когда добавляющие потоки завершили работу
+    Vector<T> Freeze(){
+        const size_t size = Size();
+        assert(size == reserved_.load(std::memory_order_relaxed));
+        Vector<T> result;
+        if constexpr(std::is_trivially_copyable_v<T>){
+            result.ResizeAndOverwrite(size, [this](T* data, size_t count) {
+                for(size_t segment = 0; Segments::Start(segment) < count; ++segment){
+                    const size_t start = Segments::Start(segment);
+                    const size_t length = std::min(Segments::Size(segment), count - start);
+                    std::memcpy(static_cast<void*>(data + start), segments_[segment].load()->elements, length * sizeof(T));
+                }
+                return count;
+            });
+        } else {
+            result.Reserve(size);
+            for(size_t i = 0; i < size; ++i){
+                result.EmplaceBack(std::move(*Slot(i)));
+            }
+        }
+        Destroy();
+        return result;
+    }
+
+private:
+    struct Segment {
+        explicit Segment(size_t size)
+        : ready(new std::atomic<bool>[size]())
+        , elements(static_cast<T*>(::operator new(size * sizeof(T), std::align_val_t{alignof(T)}))){
+        }
+
+        Segment(const Segment&) = delete;
+        Segment& operator=(const Segment&) = delete;
+
+        ~Segment(){
+            ::operator delete(elements, std::align_val_t{alignof(T)});
+        }
+
+        std::unique_ptr<std::atomic<bool>[]> ready;
+        T* elements;
+    };
+
+    T* Slot(size_t index) noexcept {
+        const size_t segment = Segments::Of(index);
+        return segments_[segment].load(std::memory_order_acquire)->elements + (index - Segments::Start(segment));
+    }
+
+    std::atomic<bool>& ReadyFlag(size_t index) noexcept {
+        const size_t segment = Segments::Of(index);
+        return segments_[segment].load(std::memory_order_acquire)->ready[index - Segments::Start(segment)];
+    }
+
+    Segment& GetSegment(size_t segment){
+        assert(segment < Segments::MAX_COUNT);
+        Segment* current = segments_[segment].load(std::memory_order_acquire);
+        if(current == nullptr){
+            auto fresh = std::make_unique<Segment>(Segments::Size(segment));
+            if(segments_[segment].compare_exchange_strong(current, fresh.get(), std::memory_order_acq_rel)){
+                current = fresh.release();
+            }
+        }
+        return *current;
+    }
+
+    // Занимает индекс следующей ячейки, предварительно выделив её сегмент
+    size_t ReserveSlot(){
+        size_t index = reserved_.load(std::memory_order_relaxed);
+        do {
+            GetSegment(Segments::Of(index));
+        } while(!reserved_.compare_exchange_weak(index, index + 1, std::memory_order_release,
+                                                  std::memory_order_relaxed));
+        return index;
+    }
+
+    // Отмечает элемент построенным и продвигает published_ через все подряд
+    // построенные элементы. Продвигать счётчик может любой поток, поэтому
+    // медленный поток задерживает публикацию, но не блокирует остальных.
+    // Запись флага и все следующие за ней загрузки (published_, reserved_ и флагов)
+    // и CAS published_ - seq_cst, так что ни одна из них не переупорядочивается до
+    // записи флага. Иначе два потока с соседними индексами могут не увидеть флаги
+    // друг друга, и последний элемент не будет опубликован
+    void Publish(size_t index) noexcept {
+        ReadyFlag(index).store(true, std::memory_order_seq_cst);
+        size_t published = published_.load(std::memory_order_seq_cst);
+        while(published < reserved_.load(std::memory_order_seq_cst)
+              && ReadyFlag(published).load(std::memory_order_seq_cst)){
+            if(published_.compare_exchange_weak(published, published + 1, std::memory_order_seq_cst)){
+                ++published;
+            }
+        }
+    }
+
+    void Destroy() noexcept {
+        const size_t size = reserved_.load(std::memory_order_relaxed);
+        for(size_t segment = 0; segment < Segments::MAX_COUNT; ++segment){
+            Segment* current = segments_[segment].exchange(nullptr);
+            if(current == nullptr){
+                continue;
+            }
+            const size_t start = Segments::Start(segment);
+            if(start < size){
+                std::destroy_n(current->elements, std::min(Segments::Size(segment), size - start));
+            }
+            delete current;
+        }
+        reserved_ = 0;
+        published_ = 0;
+    }
+
+    std::atomic<Segment*> segments_[Segments::MAX_COUNT] = {};
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> reserved_ = 0;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> published_ = 0;
+};
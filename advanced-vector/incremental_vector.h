@@ -0,0 +1,237 @@
+#pragma once
+#include "index_iterator.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <new>
+#include <utility>
+
+// Вектор, растущий без пауз на перенос всех элементов. Когда буфер заполнен,
+// выделяется новый, а элементы переносятся в него понемногу при каждом
+// следующем добавлении, как при инкрементальном рехешировании. Шаг переноса
+// подбирается так, чтобы перенос завершился раньше, чем заполнится новый буфер.
+// Во время переноса operator[] обращается к обоим буферам, а begin() и end()
+// сначала завершают перенос, поэтому элементы по-прежнему лежат непрерывно.
+// Константные begin() и end() не меняют вектор и обходят оба буфера через operator[]
+template <typename T, typename GrowthPolicy = DoublingGrowth>
+class IncrementalVector {
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = IndexIterator<IncrementalVector, true>;
+
+    IncrementalVector() noexcept = default;
+
+    IncrementalVector(const IncrementalVector& other)
+    : data_(other.size_)
+    {
+        size_t i = 0;
+        try {
+            for(; i < other.size_; ++i){
+                new (data_ + i) T(other[i]);
+            }
+        } catch(...){
+            std::destroy_n(data_.GetAddress(), i);
+            throw;
+        }
+        size_ = other.size_;
+    }
+
+    IncrementalVector(IncrementalVector&& other) noexcept {
+        Swap(other);
+    }
+
+    IncrementalVector& operator=(const IncrementalVector& rhs){
+        if(this != &rhs){
+            IncrementalVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    IncrementalVector& operator=(IncrementalVector&& rhs) noexcept {
+        if(this != &rhs){
+            Clear();
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    ~IncrementalVector(){
+        Clear();
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return data_.Capacity();
+    }
+
+    // Число элементов, ещё не перенесённых из старого буфера
+    size_t PendingMigration() const noexcept {
+        return old_size_ - migrated_;
+    }
+
+    // Переносит оставшиеся элементы и освобождает старый буфер
+    void FinishMigration(){
+        if(PendingMigration() != 0){
+            Migrate(PendingMigration());
+        }
+    }
+
+    // Завершает перенос и перевыделяет память целиком, как Vector::Reserve
+    void Reserve(size_t new_capacity){
+        if(new_capacity <= data_.Capacity()){
+            return;
+        }
+
+        FinishMigration();
+        RawMemory<T> new_data(new_capacity);
+        UninitializedRelocateN(data_.GetAddress(), size_, new_data.GetAddress());
+        DestroyRelocatedN(data_.GetAddress(), size_);
+        data_.Swap(new_data);
+    }
+
+    void PushBack(const T& value){
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value){
+        EmplaceBack(std::move(value));
+    }
+
+    // Выполняет O(1) работы, не считая построения элемента. Элемент строится
+    // до очередного шага переноса, поэтому аргументы могут ссылаться на элементы вектора
+    template <typename... Args>
+    T& EmplaceBack(Args&&... ctor_args){
+        if(size_ == data_.Capacity()){
+            StartMigration();
+        }
+        T* const elem = new (data_ + size_) T(std::forward<Args>(ctor_args)...);
+        if(PendingMigration() != 0){
+            try {
+                Migrate(std::min(step_, PendingMigration()));
+            } catch(...){
+                std::destroy_at(elem);
+                throw;
+            }
+        }
+        ++size_;
+        return *elem;
+    }
+
+    void PopBack() noexcept {
+        assert(size_ != 0);
+        --size_;
+        std::destroy_at(Slot(size_));
+        if(size_ < old_size_){
+            old_size_ = size_;
+            if(PendingMigration() == 0){
+                ReleaseOldData();
+            }
+        }
+    }
+
+    void Clear() noexcept {
+        for(size_t i = 0; i < size_; ++i){
+            std::destroy_at(Slot(i));
+        }
+        size_ = 0;
+        ReleaseOldData();
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<IncrementalVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return *Slot(index);
+    }
+
+    iterator begin(){
+        FinishMigration();
+        return data_.GetAddress();
+    }
+
+    iterator end(){
+        return begin() + size_;
+    }
+
+    const_iterator begin() const noexcept {
+        return {this, 0};
+    }
+
+    const_iterator end() const noexcept {
+        return {this, size_};
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    void Swap(IncrementalVector& other) noexcept {
+        data_.Swap(other.data_);
+        old_data_.Swap(other.old_data_);
+        std::swap(size_, other.size_);
+        std::swap(old_size_, other.old_size_);
+        std::swap(migrated_, other.migrated_);
+        std::swap(step_, other.step_);
+    }
+
+private:
+    // Элементы [migrated_, old_size_) ещё лежат в старом буфере
+    T* Slot(size_t index) noexcept {
+        if(index >= migrated_ && index < old_size_){
+            return old_data_ + index;
+        }
+        return data_ + index;
+    }
+
+    void StartMigration(){
+        // Шаг переноса рассчитан на то, что предыдущий перенос уже завершён
+        assert(PendingMigration() == 0);
+        const size_t new_capacity = GrowthPolicy::NextCapacity(data_.Capacity(), sizeof(T));
+        assert(new_capacity > size_);
+        RawMemory<T> new_data(new_capacity);
+        old_data_.Swap(data_);
+        data_.Swap(new_data);
+        old_size_ = size_;
+        migrated_ = 0;
+        const size_t free_slots = new_capacity - size_;
+        step_ = (old_size_ + free_slots - 1) / free_slots;
+        if(old_size_ == 0){
+            ReleaseOldData();
+        }
+    }
+
+    void Migrate(size_t count){
+        UninitializedRelocateN(old_data_ + migrated_, count, data_ + migrated_);
+        DestroyRelocatedN(old_data_ + migrated_, count);
+        migrated_ += count;
+        if(PendingMigration() == 0){
+            ReleaseOldData();
+        }
+    }
+
+    void ReleaseOldData() noexcept {
+        old_data_ = RawMemory<T>();
+        old_size_ = 0;
+        migrated_ = 0;
+    }
+
+    RawMemory<T> data_;
+    RawMemory<T> old_data_;
+    size_t size_ = 0;
+    size_t old_size_ = 0;
+    size_t migrated_ = 0;
+    size_t step_ = 0;
+};
@@ -0,0 +1,117 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+// Итератор произвольного доступа для контейнеров с несмежным хранением
+// (SegmentedVector, RingVector, IncrementalVector): хранит контейнер и индекс элемента и
+// обращается к элементам через Container::operator[]
+template <typename Container, bool IsConst>
+class IndexIterator {
+    using Owner = std::conditional_t<IsConst, const Container, Container>;
+    using T = typename Container::value_type;
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<IsConst, const T*, T*>;
+    using reference = std::conditional_t<IsConst, const T&, T&>;
+
+    IndexIterator() noexcept = default;
+
+    IndexIterator(Owner* owner, size_t index) noexcept
+    : owner_(owner), index_(index){}
+
+    // Неконстантный итератор приводится к константному
+    operator IndexIterator<Container, true>() const noexcept {
+        return {owner_, index_};
+    }
+
+    reference operator*() const noexcept {
+        return (*owner_)[index_];
+    }
+
+    pointer operator->() const noexcept {
+        return &**this;
+    }
+
+    reference operator[](difference_type offset) const noexcept {
+        return (*owner_)[index_ + offset];
+    }
+
+    IndexIterator& operator++() noexcept {
+        ++index_;
+        return *this;
+    }
+
+    IndexIterator operator++(int) noexcept {
+        IndexIterator copy = *this;
+        ++index_;
+        return copy;
+    }
+
+    IndexIterator& operator--() noexcept {
+        --index_;
+        return *this;
+    }
+
+    IndexIterator operator--(int) noexcept {
+        IndexIterator copy = *this;
+        --index_;
+        return copy;
+    }
+
+    IndexIterator& operator+=(difference_type offset) noexcept {
+        index_ += offset;
+        return *this;
+    }
+
+    IndexIterator& operator-=(difference_type offset) noexcept {
+        index_ -= offset;
+        return *this;
+    }
+
+    friend IndexIterator operator+(IndexIterator it, difference_type offset) noexcept {
+        return it += offset;
+    }
+
+    friend IndexIterator operator+(difference_type offset, IndexIterator it) noexcept {
+        return it += offset;
+    }
+
+    friend IndexIterator operator-(IndexIterator it, difference_type offset) noexcept {
+        return it -= offset;
+    }
+
+    friend difference_type operator-(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+        return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+    }
+
+    friend bool operator==(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+        return lhs.index_ == rhs.index_;
+    }
+
+    friend bool operator!=(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+        return lhs.index_ != rhs.index_;
+    }
+
+    friend bool operator<(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+        return lhs.index_ < rhs.index_;
+    }
+
+    friend bool operator>(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+        return rhs < lhs;
+    }
+
+    friend bool operator<=(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+        return !(rhs < lhs);
+    }
+
+    friend bool operator>=(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+        return !(lhs < rhs);
+    }
+
+private:
+    Owner* owner_ = nullptr;
+    size_t index_ = 0;
+};
@@ -1,8 +1,35 @@
+#include "aligned_allocator.h"
+#include "concurrent_vector.h"
+#include "flat_containers.h"
+#include "incremental_vector.h"
+#include "mapped_vector.h"
+#include "numa_allocator.h"
+#include "parallel.h"
+#include "pool_allocator.h"
+#include "ring_vector.h"
+#include "segmented_vector.h"
+#include "serialization.h"
+#include "shared_vector.h"
+#include "small_vector.h"
+#include "soa_vector.h"
+#include "spsc_queue.h"
+#include "static_vector.h"
 #include "vector.h"
+#include "vector_algorithms.h"
+#include "vector_view.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace {
@@ -126,8 +153,91 @@ std::ostream& operator<<(std::ostream& out, const Obj& value){
     return out;
 }
 
+struct AllocStats {
+    size_t allocations = 0;
+    size_t deallocations = 0;
+    size_t bytes_in_use = 0;
+};
+
+// Аллокатор с состоянием: позволяет проверить, какой аллокатор освобождает память
+template <typename T, bool Propagate>
+struct TrackingAllocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::bool_constant<Propagate>;
+    using propagate_on_container_move_assignment = std::bool_constant<Propagate>;
+    using propagate_on_container_swap = std::bool_constant<Propagate>;
+    using is_always_equal = std::false_type;
+
+    explicit TrackingAllocator(AllocStats* stats) noexcept
+        : stats(stats) {
+    }
+
+    T* allocate(size_t n) {
+        ++stats->allocations;
+        stats->bytes_in_use += n * sizeof(T);
+        return static_cast<T*>(operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        ++stats->deallocations;
+        stats->bytes_in_use -= n * sizeof(T);
+        operator delete(p);
+    }
+
+    bool operator==(const TrackingAllocator& other) const noexcept {
+        return stats == other.stats;
+    }
+
+    bool operator!=(const TrackingAllocator& other) const noexcept {
+        return stats != other.stats;
+    }
+
+    AllocStats* stats;
+};
+
+// Тип с отслеживаемыми перемещениями, явно объявленный тривиально перемещаемым
+struct Relocatable {
+    explicit Relocatable(int id)
+        : id(id) {
+    }
+    Relocatable(const Relocatable& other)
+        : id(other.id) {
+        ++num_copied;
+    }
+    Relocatable(Relocatable&& other) noexcept
+        : id(other.id) {
+        ++num_moved;
+    }
+    ~Relocatable() {
+        ++num_destroyed;
+    }
+
+    static void ResetCounters() {
+        num_copied = 0;
+        num_moved = 0;
+        num_destroyed = 0;
+    }
+
+    int id;
+
+    static inline int num_copied = 0;
+    static inline int num_moved = 0;
+    static inline int num_destroyed = 0;
+};
+
+// Перемещение не помечено noexcept, поэтому при реаллокации вектор копирует элементы
+struct ThrowingMove {
+    ThrowingMove() = default;
+    ThrowingMove(const ThrowingMove&) = default;
+    ThrowingMove(ThrowingMove&&) noexcept(false) = default;
+    std::string value;
+};
+
 }  // namespace
 
+template <>
+struct is_trivially_relocatable<Relocatable> : std::true_type {};
+
 void Test1() {
     Obj::ResetCounters();
     const size_t SIZE = 100500;
@@ -568,6 +678,1931 @@ void Test6() {
     }
 }
 
+void Test7() {
+    const size_t SIZE = 10;
+    const int ID = 42;
+    assert(sizeof(RawMemory<int>) == 2 * sizeof(void*));
+    {
+        AllocStats stats;
+        {
+            using Alloc = TrackingAllocator<Obj, true>;
+            Obj::ResetCounters();
+            Vector<Obj, Alloc> v{Alloc(&stats)};
+            for(size_t i = 0; i < SIZE; ++i){
+                v.EmplaceBack(ID);
+            }
+            assert(v.Size() == SIZE);
+            assert(stats.allocations > 0);
+            assert(stats.bytes_in_use == v.Capacity() * sizeof(Obj));
+        }
+        assert(stats.allocations == stats.deallocations);
+        assert(stats.bytes_in_use == 0);
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        using Alloc = TrackingAllocator<int, true>;
+        AllocStats lhs_stats;
+        AllocStats rhs_stats;
+        {
+            Vector<int, Alloc> lhs(SIZE, Alloc(&lhs_stats));
+            Vector<int, Alloc> rhs(SIZE / 2, Alloc(&rhs_stats));
+            rhs[0] = ID;
+            // Аллокатор распространяется при копирующем присваивании
+            lhs = rhs;
+            assert(lhs.GetAllocator() == rhs.GetAllocator());
+            assert(lhs.Size() == SIZE / 2);
+            assert(lhs[0] == ID);
+            assert(lhs_stats.bytes_in_use == 0);
+
+            Vector<int, Alloc> other(SIZE, Alloc(&lhs_stats));
+            other.Swap(lhs);
+            assert(other.GetAllocator() == Alloc(&rhs_stats));
+            assert(lhs.GetAllocator() == Alloc(&lhs_stats));
+            assert(other[0] == ID);
+        }
+        assert(lhs_stats.bytes_in_use == 0);
+        assert(rhs_stats.bytes_in_use == 0);
+        assert(lhs_stats.allocations == lhs_stats.deallocations);
+        assert(rhs_stats.allocations == rhs_stats.deallocations);
+    }
+    {
+        using Alloc = TrackingAllocator<Obj, false>;
+        AllocStats lhs_stats;
+        AllocStats rhs_stats;
+        Obj::ResetCounters();
+        {
+            Vector<Obj, Alloc> lhs(SIZE, Alloc(&lhs_stats));
+            Vector<Obj, Alloc> rhs(SIZE / 2, Alloc(&rhs_stats));
+            rhs[0].id = ID;
+            // Аллокаторы не распространяются и различны: элементы перемещаются по одному
+            lhs = std::move(rhs);
+            assert(lhs.GetAllocator() == Alloc(&lhs_stats));
+            assert(lhs.Size() == SIZE / 2);
+            assert(lhs[0].id == ID);
+            assert(Obj::num_moved == SIZE / 2);
+            assert(Obj::GetAliveObjectCount() == SIZE);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+        assert(lhs_stats.bytes_in_use == 0);
+        assert(rhs_stats.bytes_in_use == 0);
+    }
+    {
+        Obj::ResetCounters();
+        {
+            Vector<Obj> v(SIZE);
+            Vector<Obj> other(SIZE / 2);
+            v = std::move(other);
+            assert(v.Size() == SIZE / 2);
+            assert(Obj::GetAliveObjectCount() == SIZE / 2);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+void Test8() {
+    using namespace std::literals;
+    const int SIZE = 1000;
+    static_assert(is_trivially_relocatable_v<int>);
+    static_assert(is_trivially_relocatable_v<std::unique_ptr<int>>);
+    static_assert(!is_trivially_relocatable_v<Obj>);
+    {
+        Vector<std::unique_ptr<int>> v;
+        for(int i = 0; i < SIZE; ++i){
+            v.PushBack(std::make_unique<int>(i));
+        }
+        v.Emplace(v.cbegin() + SIZE / 2, std::make_unique<int>(-1));
+        assert(v.Size() == SIZE + 1);
+        assert(*v[SIZE / 2] == -1);
+        assert(*v[SIZE / 2 + 1] == SIZE / 2);
+        assert(*v[SIZE] == SIZE - 1);
+    }
+    {
+        Vector<std::unique_ptr<int>> v;
+        v.PushBack(std::make_unique<int>(SIZE));
+        assert(v.Size() == v.Capacity());
+        // Перемещение собственного элемента при реаллокации
+        v.PushBack(std::move(v[0]));
+        assert(v[0] == nullptr);
+        assert(*v[1] == SIZE);
+    }
+    {
+        Relocatable::ResetCounters();
+        {
+            Vector<Relocatable> v;
+            for(int i = 0; i < SIZE; ++i){
+                v.EmplaceBack(i);
+            }
+            v.Reserve(SIZE * 4);
+            assert(Relocatable::num_moved == 0);
+            assert(Relocatable::num_copied == 0);
+            assert(Relocatable::num_destroyed == 0);
+            assert(v[0].id == 0);
+            assert(v[SIZE - 1].id == SIZE - 1);
+        }
+        assert(Relocatable::num_destroyed == SIZE);
+    }
+    {
+        Vector<std::string> v;
+        v.PushBack("a fairly long string to avoid small string optimization"s);
+        assert(v.Size() == v.Capacity());
+        // Копирование собственного элемента при реаллокации
+        v.PushBack(v[0]);
+        assert(v[1] == v[0]);
+        assert(v[0] == "a fairly long string to avoid small string optimization"s);
+    }
+}
+
+void Test9() {
+    {
+        Vector<int, std::allocator<int>, GrowthFactor<3, 2>> v;
+        std::vector<size_t> capacities;
+        for(int i = 0; i < 20; ++i){
+            v.PushBack(i);
+            if(capacities.empty() || capacities.back() != v.Capacity()){
+                capacities.push_back(v.Capacity());
+            }
+        }
+        const std::vector<size_t> expected{1, 2, 3, 4, 6, 9, 13, 19, 28};
+        assert(capacities == expected);
+        for(int i = 0; i < 20; ++i){
+            assert(v[i] == i);
+        }
+    }
+    {
+        Vector<int, std::allocator<int>, MinCapacityGrowth<16>> v;
+        v.EmplaceBack(1);
+        assert(v.Capacity() == 16);
+        v.Resize(16);
+        v.Emplace(v.cbegin(), 0);
+        assert(v.Capacity() == 32);
+        assert(v[0] == 0);
+        assert(v[1] == 1);
+    }
+    {
+        using Policy = SizeClassGrowth<>;
+        assert(Policy::RoundUpToSizeClass(1) == 16);
+        assert(Policy::RoundUpToSizeClass(17) == 32);
+        assert(Policy::RoundUpToSizeClass(33) == 48);
+        assert(Policy::RoundUpToSizeClass(129) == 160);
+        assert(Policy::RoundUpToSizeClass(1000) == 1024);
+        assert(Policy::RoundUpToSizeClass(1025) == 1280);
+
+        Vector<int, std::allocator<int>, Policy> v;
+        for(int i = 0; i < 1000; ++i){
+            v.PushBack(i);
+            assert(Policy::RoundUpToSizeClass(v.Capacity() * sizeof(int)) == v.Capacity() * sizeof(int));
+        }
+        assert(v[999] == 999);
+    }
+}
+
+void Test10() {
+    using namespace std::literals;
+    const size_t SIZE = 8;
+    const int ID = 42;
+    {
+        Obj::ResetCounters();
+        SmallVector<Obj, SIZE> v;
+        for(size_t i = 0; i < SIZE; ++i){
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        assert(v.IsInline());
+        assert(v.Capacity() == SIZE);
+        const auto* object_begin = reinterpret_cast<const char*>(&v);
+        const auto* first_elem = reinterpret_cast<const char*>(&v[0]);
+        assert(first_elem >= object_begin && first_elem < object_begin + sizeof(v));
+
+        v.Insert(v.cbegin() + 1, Obj{ID});
+        assert(!v.IsInline());
+        assert(v.Size() == SIZE + 1);
+        assert(v.Capacity() == SIZE * 2);
+        assert(v[0].id == 0);
+        assert(v[1].id == ID);
+        assert(v[SIZE].id == static_cast<int>(SIZE) - 1);
+        assert(Obj::num_copied == 0);
+
+        v.Erase(v.cbegin() + 1);
+        assert(v.Size() == SIZE);
+        assert(v[1].id == 1);
+        assert(Obj::GetAliveObjectCount() == SIZE);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        SmallVector<std::string, 2> v{"first"s, "second"s};
+        v.Emplace(v.cbegin(), "zero"s);
+        v.Emplace(v.cend(), "third"s);
+        v.Emplace(v.cbegin() + 2, "middle"s);
+        const std::vector<std::string> expected{"zero"s, "first"s, "middle"s, "second"s, "third"s};
+        assert(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+
+        v.Resize(1);
+        assert(v.Size() == 1);
+        assert(v[0] == "zero"s);
+        v.Reserve(100);
+        assert(v.Capacity() == 100);
+        assert(v[0] == "zero"s);
+    }
+    {
+        Obj::ResetCounters();
+        SmallVector<Obj, SIZE> inline_v(SIZE / 2);
+        inline_v[0].id = ID;
+        SmallVector<Obj, SIZE> heap_v(SIZE * 2);
+        heap_v[0].id = ID + 1;
+
+        SmallVector<Obj, SIZE> inline_copy(inline_v);
+        assert(inline_copy.IsInline());
+        assert(inline_copy[0].id == ID);
+
+        SmallVector<Obj, SIZE> moved_inline(std::move(inline_v));
+        assert(moved_inline.IsInline());
+        assert(moved_inline.Size() == SIZE / 2);
+        assert(inline_v.Size() == 0);
+
+        const Obj* heap_data = &heap_v[0];
+        SmallVector<Obj, SIZE> moved_heap(std::move(heap_v));
+        assert(&moved_heap[0] == heap_data);
+        assert(heap_v.Size() == 0);
+
+        moved_inline.Swap(moved_heap);
+        assert(moved_inline.Size() == SIZE * 2);
+        assert(moved_inline[0].id == ID + 1);
+        assert(moved_heap.Size() == SIZE / 2);
+        assert(moved_heap[0].id == ID);
+
+        inline_copy = moved_inline;
+        assert(inline_copy.Size() == SIZE * 2);
+        assert(inline_copy[0].id == ID + 1);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Строгая гарантия при исключении во время переноса в динамическую память
+        Obj::ResetCounters();
+        SmallVector<Obj, SIZE> v(SIZE);
+        Obj::default_construction_throw_countdown = 1;
+        try {
+            v.EmplaceBack();
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.IsInline());
+        assert(v.Size() == SIZE);
+        assert(Obj::GetAliveObjectCount() == SIZE);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test11() {
+    using namespace std::literals;
+    const size_t SIZE = 10;
+    const int ID = 42;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        std::vector<Obj> source(SIZE / 2, Obj{ID});
+        const int copies_before = Obj::num_copied;
+        auto pos = v.Insert(v.cbegin() + 2, source.begin(), source.end());
+        assert(pos == v.begin() + 2);
+        assert(v.Size() == SIZE + SIZE / 2);
+        assert(v.Capacity() == SIZE * 2);
+        assert(Obj::num_copied - copies_before == static_cast<int>(SIZE / 2));
+        assert(Obj::num_moved == static_cast<int>(SIZE));
+        assert(v[1].id == 0);
+        assert(v[2].id == ID);
+        assert(v[6].id == ID);
+        assert(v[7].id == 0);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Вставка без реаллокации: хвост длиннее и короче вставляемого диапазона
+        for(size_t index : {0, 2, 8, 10}){
+            Vector<std::string> v;
+            v.Reserve(SIZE * 2);
+            for(size_t i = 0; i < SIZE; ++i){
+                v.PushBack(std::to_string(i));
+            }
+            const std::vector<std::string> source{"a"s, "b"s, "c"s};
+            v.Insert(v.cbegin() + index, source.begin(), source.end());
+            std::vector<std::string> expected;
+            for(size_t i = 0; i < SIZE; ++i){
+                expected.push_back(std::to_string(i));
+            }
+            expected.insert(expected.begin() + index, source.begin(), source.end());
+            assert(v.Capacity() == SIZE * 2);
+            assert(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+        }
+    }
+    {
+        Vector<int> v{1, 2, 3};
+        v.Reserve(16);
+        v.Insert(v.cbegin() + 1, 3, v[2]);
+        const std::vector<int> expected{1, 3, 3, 3, 2, 3};
+        assert(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+        v.Insert(v.cend(), 20, 7);
+        assert(v.Size() == 26);
+        assert(v[25] == 7);
+    }
+    {
+        const int values[] = {4, 5, 6};
+        Vector<int> v(values, values + 3);
+        assert(v.Size() == 3);
+        assert(v.Capacity() == 3);
+        v.Append(values);
+        v.Append(std::vector<int>{7, 8});
+        const std::vector<int> expected{4, 5, 6, 4, 5, 6, 7, 8};
+        assert(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+    }
+    {
+        std::istringstream input("1 2 3 4");
+        Vector<int> v(std::istream_iterator<int>(input), std::istream_iterator<int>{});
+        assert(v.Size() == 4);
+        std::istringstream tail("5 6");
+        v.Insert(v.cbegin() + 1, std::istream_iterator<int>(tail), std::istream_iterator<int>{});
+        const std::vector<int> expected{1, 5, 6, 2, 3, 4};
+        assert(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+    }
+}
+
+void Test12() {
+    const size_t SIZE = 10;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        for(size_t i = 0; i < SIZE; ++i){
+            v[i].id = static_cast<int>(i);
+        }
+        auto pos = v.Erase(v.cbegin() + 2, v.cbegin() + 5);
+        assert(pos == v.begin() + 2);
+        assert(v.Size() == SIZE - 3);
+        assert(v.Capacity() == SIZE);
+        assert(v[1].id == 1);
+        assert(v[2].id == 5);
+        assert(v[SIZE - 4].id == static_cast<int>(SIZE) - 1);
+        assert(Obj::num_move_assigned == static_cast<int>(SIZE) - 5);
+        assert(Obj::num_destroyed == 3);
+
+        pos = v.Erase(v.cbegin() + 1, v.cbegin() + 1);
+        assert(pos == v.begin() + 1);
+        assert(v.Size() == SIZE - 3);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Vector<std::unique_ptr<int>> v;
+        for(size_t i = 0; i < SIZE; ++i){
+            v.PushBack(std::make_unique<int>(static_cast<int>(i)));
+        }
+        v.Erase(v.cbegin(), v.cbegin() + 3);
+        assert(v.Size() == SIZE - 3);
+        assert(*v[0] == 3);
+        v.Erase(v.cbegin() + 2, v.cend());
+        assert(v.Size() == 2);
+        assert(*v[1] == 4);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        for(size_t i = 0; i < SIZE; ++i){
+            v[i].id = static_cast<int>(i);
+        }
+        const size_t removed = EraseIf(v, [](const Obj& obj) {
+            return obj.id % 3 == 0;
+        });
+        assert(removed == 4);
+        assert(v.Size() == SIZE - 4);
+        const std::vector<int> expected{1, 2, 4, 5, 7, 8};
+        assert(std::equal(v.begin(), v.end(), expected.begin(), expected.end(), [](const Obj& obj, int id) {
+            return obj.id == id;
+        }));
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE) - 4);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        for(size_t i = 0; i < SIZE; ++i){
+            v[i].id = static_cast<int>(i);
+        }
+        auto pos = v.SwapErase(v.cbegin() + 2);
+        assert(pos == v.begin() + 2);
+        assert(v.Size() == SIZE - 1);
+        assert(v[2].id == static_cast<int>(SIZE) - 1);
+        assert(Obj::num_move_assigned == 1);
+        v.SwapErase(v.cend() - 1);
+        assert(v.Size() == SIZE - 2);
+        assert(v[SIZE - 3].id == static_cast<int>(SIZE) - 3);
+        assert(Obj::num_move_assigned == 1);
+    }
+}
+
+void Test13() {
+    const size_t SIZE = 100;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE, default_init);
+        assert(v.Size() == SIZE);
+        assert(Obj::num_default_constructed == static_cast<int>(SIZE));
+        v.ResizeDefaultInit(SIZE * 2);
+        assert(v.Size() == SIZE * 2);
+        assert(Obj::num_default_constructed == static_cast<int>(SIZE * 2));
+        v.ResizeDefaultInit(SIZE / 2);
+        assert(v.Size() == SIZE / 2);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE / 2));
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Vector<int> v{1, 2, 3};
+        v.ResizeAndOverwrite(SIZE, [](int* data, size_t count) {
+            assert(data[2] == 3);
+            for(size_t i = 3; i < count; ++i){
+                data[i] = static_cast<int>(i);
+            }
+            return count / 2;
+        });
+        assert(v.Size() == SIZE / 2);
+        assert(v[0] == 1);
+        assert(v[SIZE / 2 - 1] == static_cast<int>(SIZE / 2) - 1);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        try {
+            v.ResizeAndOverwrite(SIZE * 2, [](Obj*, size_t) -> size_t {
+                throw std::runtime_error("Oops");
+            });
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE));
+
+        v.ResizeAndOverwrite(SIZE / 2, [](Obj* data, size_t count) {
+            data[0].id = 1;
+            return count - 1;
+        });
+        assert(v.Size() == SIZE / 2 - 1);
+        assert(v[0].id == 1);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE / 2) - 1);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test14() {
+    const size_t SIZE = 100;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v.Resize(SIZE / 2);
+        v.ShrinkToFit();
+        assert(v.Size() == SIZE / 2);
+        assert(v.Capacity() == SIZE / 2);
+        assert(Obj::num_moved == static_cast<int>(SIZE / 2));
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE / 2));
+
+        v.ShrinkToFit();
+        assert(Obj::num_moved == static_cast<int>(SIZE / 2));
+
+        v.Clear();
+        assert(v.Size() == 0);
+        assert(v.Capacity() == SIZE / 2);
+        assert(Obj::GetAliveObjectCount() == 0);
+
+        v.EmplaceBack(1);
+        v.Release();
+        assert(v.Size() == 0);
+        assert(v.Capacity() == 0);
+        assert(v.begin() == nullptr);
+        assert(Obj::GetAliveObjectCount() == 0);
+
+        v.EmplaceBack(1);
+        assert(v.Size() == 1);
+        assert(v[0].id == 1);
+    }
+    {
+        AllocStats stats;
+        {
+            using Alloc = TrackingAllocator<int, true>;
+            Vector<int, Alloc> v(SIZE, Alloc(&stats));
+            v.Resize(1);
+            assert(stats.bytes_in_use == SIZE * sizeof(int));
+            v.ShrinkToFit();
+            assert(stats.bytes_in_use == sizeof(int));
+            v.Release();
+            assert(stats.bytes_in_use == 0);
+        }
+        assert(stats.allocations == stats.deallocations);
+    }
+}
+
+void Test15() {
+    const size_t SIZE = 10;
+    {
+        // Вставка в конец при наличии свободного места
+        Vector<int> v(SIZE);
+        v.Reserve(SIZE * 2);
+        auto pos = v.Insert(v.cend(), 1);
+        assert(pos == v.end() - 1);
+        assert(v.Size() == SIZE + 1);
+        assert(v[SIZE - 1] == 0);
+        assert(v[SIZE] == 1);
+    }
+}
+
+void Test16() {
+    using CountingVector = Vector<int, std::allocator<int>, DoublingGrowth, CountingInstrumentation>;
+    assert(sizeof(Vector<int>) == 3 * sizeof(void*));
+    {
+        CountingVector v;
+        for(int i = 0; i < 10; ++i){
+            v.PushBack(i);
+        }
+        const VectorStats& stats = v.GetInstrumentation().GetStats();
+        assert(stats.allocations == 5);
+        assert(stats.growth_reallocations == 5);
+        assert(stats.bytes_allocated == (1 + 2 + 4 + 8 + 16) * sizeof(int));
+        assert(stats.elements_relocated == 1 + 2 + 4 + 8);
+        assert(stats.elements_moved == 0);
+        assert(stats.peak_capacity == 16);
+
+        v.GetInstrumentation().ResetStats();
+        v.Reserve(100);
+        v.Insert(v.cbegin(), 5, 0);
+        assert(stats.allocations == 1);
+        assert(stats.growth_reallocations == 0);
+        assert(stats.peak_capacity == 100);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj, std::allocator<Obj>, DoublingGrowth, CountingInstrumentation> v(4);
+        v.EmplaceBack();
+        v.Emplace(v.cbegin(), 1);
+        const VectorStats& stats = v.GetInstrumentation().GetStats();
+        assert(stats.allocations == 2);
+        assert(stats.growth_reallocations == 1);
+        assert(stats.elements_moved == 4);
+        assert(stats.elements_copied == 0);
+    }
+    {
+        Vector<ThrowingMove, std::allocator<ThrowingMove>, DoublingGrowth, CountingInstrumentation> v(2);
+        v.Reserve(3);
+        assert(v.GetInstrumentation().GetStats().elements_copied == 2);
+    }
+}
+
+template <typename T>
+void CheckSimdAlgorithms(std::mt19937& generator) {
+    std::uniform_int_distribution<int> distribution(0, 50);
+    for(size_t size : {0, 1, 7, 31, 64, 65, 200, 1000}){
+        Vector<T> v(size);
+        for(auto& value : v){
+            value = static_cast<T>(distribution(generator));
+        }
+        const std::vector<T> expected(v.begin(), v.end());
+        const T needle = static_cast<T>(25);
+        assert(Find(v, needle) - v.begin() == std::find(expected.begin(), expected.end(), needle) - expected.begin());
+        assert(Contains(v, needle) == (std::count(expected.begin(), expected.end(), needle) != 0));
+        assert(Count(v, needle) == static_cast<size_t>(std::count(expected.begin(), expected.end(), needle)));
+        assert(Sum(v) == std::accumulate(expected.begin(), expected.end(), T{}));
+        if(size != 0){
+            const auto [min, max] = MinMax(v);
+            assert(min == *std::min_element(expected.begin(), expected.end()));
+            assert(max == *std::max_element(expected.begin(), expected.end()));
+        }
+
+        Vector<T> copy(v);
+        assert(copy == v);
+        if(size != 0){
+            copy[size - 1] = static_cast<T>(100);
+            assert(copy != v);
+        }
+        Fill(copy, static_cast<T>(3));
+        assert(Count(copy, static_cast<T>(3)) == size);
+    }
+}
+
+void Test17() {
+    std::mt19937 generator(42);
+    for(auto level : {simd::Level::SCALAR, simd::Level::BASE, simd::Level::AVX2, simd::Level::AVX512}){
+        simd::LimitLevel(level);
+        CheckSimdAlgorithms<signed char>(generator);
+        CheckSimdAlgorithms<unsigned short>(generator);
+        CheckSimdAlgorithms<int>(generator);
+        CheckSimdAlgorithms<unsigned long long>(generator);
+        // Значения целые и небольшие, поэтому суммы вычисляются точно при любом порядке сложения
+        CheckSimdAlgorithms<float>(generator);
+        CheckSimdAlgorithms<double>(generator);
+    }
+    {
+        // Знаковые суммы переполняются и совпадают со скалярным сложением по модулю 2^N
+        Vector<signed char> bytes(1000);
+        std::fill(bytes.begin(), bytes.end(), static_cast<signed char>(100));
+        Vector<short> shorts(1000);
+        std::fill(shorts.begin(), shorts.end(), static_cast<short>(-30000));
+        simd::LimitLevel(simd::Level::SCALAR);
+        const signed char scalar_bytes = Sum(bytes);
+        const short scalar_shorts = Sum(shorts);
+        assert(scalar_bytes == static_cast<signed char>(static_cast<unsigned char>(100 * 1000 % 256)));
+        assert(scalar_shorts == static_cast<short>(static_cast<unsigned short>(65536 - 30000 * 1000 % 65536)));
+        simd::LimitLevel(simd::DetectLevel());
+        assert(Sum(bytes) == scalar_bytes);
+        assert(Sum(shorts) == scalar_shorts);
+    }
+    simd::LimitLevel(simd::DetectLevel());
+    {
+        // Вектор дольше 127 блоков проверяет сброс узких счётчиков
+        Vector<char> v(100'000);
+        Fill(v, 'a');
+        v[77'777] = 'b';
+        assert(Count(v, 'a') == v.Size() - 1);
+        assert(Find(v, 'b') - v.begin() == 77'777);
+    }
+    {
+        using namespace std::literals;
+        Vector<std::string> v{"a"s, "b"s, "a"s};
+        assert(Count(v, "a"s) == 2);
+        assert(Find(v, "b"s) == v.begin() + 1);
+        assert(Sum(v) == "aba"s);
+        const auto [min, max] = MinMax(v);
+        assert(min == "a"s);
+        assert(max == "b"s);
+        assert(v == Vector<std::string>(v));
+    }
+}
+
+void Test18() {
+    const auto is_aligned = [](const void* ptr, size_t alignment) {
+        return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+    };
+    {
+        AlignedVector<char> v;
+        for(int i = 0; i < 1000; ++i){
+            v.PushBack(static_cast<char>(i));
+            assert(is_aligned(v.begin(), CACHE_LINE_SIZE));
+        }
+        AlignedVector<char> copy(v);
+        assert(is_aligned(copy.begin(), CACHE_LINE_SIZE));
+        assert(copy == v);
+    }
+    {
+        AlignedVector<double, 32> v(3);
+        assert(is_aligned(v.begin(), 32));
+        v.Insert(v.cbegin(), 100, 1.0);
+        assert(is_aligned(v.begin(), 32));
+        assert(Sum(v) == 100.0);
+    }
+    {
+        struct alignas(128) OverAligned {
+            char data[128];
+        };
+        Vector<OverAligned> v(2);
+        assert(is_aligned(v.begin(), alignof(OverAligned)));
+    }
+    {
+        HugePageVector<char> v;
+        v.Reserve(HUGE_PAGE_SIZE / 2);
+        assert(is_aligned(v.begin(), CACHE_LINE_SIZE));
+        v.ResizeDefaultInit(HUGE_PAGE_SIZE * 3 / 2);
+        assert(is_aligned(v.begin(), HUGE_PAGE_SIZE));
+        Fill(v, 'x');
+        assert(Count(v, 'x') == v.Size());
+    }
+    {
+        // Размер в байтах не должен переполняться
+        AlignedAllocator<double> alloc;
+        try {
+            alloc.allocate(std::numeric_limits<size_t>::max() / sizeof(double) + 1);
+            assert(false);
+        } catch(const std::bad_array_new_length&){
+        }
+    }
+}
+
+void Test19() {
+    struct Record {
+        int id;
+        double value;
+    };
+    const std::string path = "mapped_vector_test.bin";
+    std::remove(path.c_str());
+    {
+        MappedVector<Record> v(path);
+        assert(v.IsOpen() && v.Size() == 0);
+        for(int i = 0; i < 1000; ++i){
+            v.PushBack({i, i * 0.5});
+        }
+        // Аргумент ссылается на элемент, который переедет при росте
+        while(v.Size() != v.Capacity()){
+            v.EmplaceBack(v[0]);
+        }
+        v.PushBack(v[1]);
+        assert(v[v.Size() - 1].id == 1);
+        v.Resize(1000);
+        v.Flush();
+    }
+    {
+        MappedVector<Record> v(path);
+        assert(v.Size() == 1000);
+        assert(v.Capacity() >= 1000);
+        for(int i = 0; i < 1000; ++i){
+            assert(v[i].id == i && v[i].value == i * 0.5);
+        }
+        v.Resize(2000);
+        assert(v[1999].id == 0);
+        v.PopBack();
+        MappedVector<Record> moved(std::move(v));
+        assert(!v.IsOpen() && v.Size() == 0);
+        assert(moved.Size() == 1999);
+        try {
+            v.PushBack({1, 1.0});
+            assert(false);
+        } catch(const std::logic_error&){
+        }
+    }
+    {
+        MappedVector<Record> v(path);
+        assert(v.Size() == 1999);
+        assert(v.end()[-1].id == 0 && v.begin()[999].id == 999);
+    }
+    try {
+        MappedVector<char> v(path);
+        assert(false);
+    } catch(const std::runtime_error&){
+    }
+    // Заголовок (64 байта) обещает 1999 элементов, а в файле осталось место для 10
+    if(truncate(path.c_str(), 64 + 10 * sizeof(Record)) != 0){
+        assert(false);
+    }
+    try {
+        MappedVector<Record> v(path);
+        assert(false);
+    } catch(const std::runtime_error&){
+    }
+    std::remove(path.c_str());
+}
+
+void Test20() {
+    using namespace std::literals;
+    std::FILE* file = std::tmpfile();
+    assert(file != nullptr);
+    const int fd = fileno(file);
+    struct Record {
+        int id;
+        double value;
+    };
+    Vector<int> numbers(300'000);
+    for(size_t i = 0; i < numbers.Size(); ++i){
+        numbers[i] = static_cast<int>(i * 7);
+    }
+    Vector<Record> records{{1, 0.5}, {2, 1.5}};
+    Vector<std::string> strings{"snapshot"s, ""s, std::string(100'000, 'x')};
+    const auto write_string = [](BinaryWriter& out, const std::string& str) {
+        out.WriteValue<uint64_t>(str.size());
+        out.Write(str.data(), str.size());
+    };
+    const auto read_string = [](BinaryReader& in) {
+        std::string str(in.ReadValue<uint64_t>(), '\0');
+        in.Read(str.data(), str.size());
+        return str;
+    };
+    {
+        BinaryWriter out(fd, 16);
+        Serialize(out, numbers);
+        Serialize(out, strings, write_string);
+        Serialize(out, records);
+        Serialize(out, Vector<int>{});
+        Serialize(out, numbers);
+    }
+    std::rewind(file);
+    {
+        BinaryReader in(fd, 100);
+        Vector<int> v{1, 2, 3};
+        Deserialize(in, v);
+        assert(v == numbers);
+        Vector<std::string> s;
+        Deserialize(in, s, read_string);
+        assert(s == strings);
+        Vector<Record> r;
+        Deserialize(in, r);
+        assert(r.Size() == 2 && r[1].id == 2 && r[1].value == 1.5);
+        Deserialize(in, v);
+        assert(v.Size() == 0);
+        // Тип элемента не совпадает с записанным
+        try {
+            Vector<char> c;
+            Deserialize(in, c);
+            assert(false);
+        } catch(const std::runtime_error&){
+        }
+        Vector<char> skipped(numbers.Size() * sizeof(int), default_init);
+        in.Read(skipped.begin(), skipped.Size());
+        // Поток закончился раньше, чем ожидалось
+        try {
+            Deserialize(in, v);
+            assert(false);
+        } catch(const std::runtime_error&){
+            assert(v.Size() == 0);
+        }
+    }
+    std::fclose(file);
+
+    // Повреждённый заголовок с огромным размером не приводит к огромному выделению
+    for(const uint32_t element_size : {static_cast<uint32_t>(sizeof(int)), SerializationHeader::VARIABLE_ELEMENT_SIZE}){
+        file = std::tmpfile();
+        assert(file != nullptr);
+        {
+            BinaryWriter out(fileno(file));
+            SerializationHeader header;
+            header.size = uint64_t{1} << 50;
+            header.element_size = element_size;
+            out.WriteValue(header);
+            out.WriteValue(1);
+            out.Flush();
+        }
+        std::rewind(file);
+        BinaryReader in(fileno(file));
+        Vector<int> v;
+        try {
+            if(element_size == SerializationHeader::VARIABLE_ELEMENT_SIZE){
+                Deserialize(in, v, [](BinaryReader& reader) {
+                    return reader.ReadValue<int>();
+                });
+            } else {
+                Deserialize(in, v);
+            }
+            assert(false);
+        } catch(const std::runtime_error&){
+            assert(v.Capacity() <= detail::MaxReservedElements<int>());
+        }
+        std::fclose(file);
+    }
+}
+
+void Test21() {
+    ThreadPool pool(3);
+    for(size_t grain : {0, 1, 7, 1000}){
+        ParallelOptions options{&pool, grain};
+        Vector<int> v(10'000);
+        std::iota(v.begin(), v.end(), 0);
+
+        ParallelForEach(v, [](int& x) {
+            x *= 2;
+        }, options);
+        for(size_t i = 0; i < v.Size(); ++i){
+            assert(v[i] == static_cast<int>(i * 2));
+        }
+
+        Vector<long long> squares;
+        ParallelTransform(v, squares, [](int x) {
+            return static_cast<long long>(x) * x;
+        }, options);
+        assert(squares.Size() == v.Size());
+        assert(squares[9'999] == 19'998LL * 19'998);
+
+        assert(ParallelReduce(v, 0LL, std::plus<>{}, options) == 9'999LL * 10'000);
+        // Порядок объединения порций сохраняется и для некоммутативной операции
+        Vector<std::string> letters(26);
+        for(size_t i = 0; i < letters.Size(); ++i){
+            letters[i] = std::string(1, static_cast<char>('a' + i));
+        }
+        assert(ParallelReduce(letters, std::string(">"), std::plus<>{}, options) == ">abcdefghijklmnopqrstuvwxyz");
+
+        std::mt19937 generator(static_cast<unsigned>(grain));
+        for(int& x : v){
+            x = static_cast<int>(generator() % 1000);
+        }
+        std::vector<int> expected(v.begin(), v.end());
+        std::sort(expected.begin(), expected.end(), std::greater<>{});
+        ParallelSort(v, std::greater<>{}, options);
+        assert(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+    }
+    {
+        Vector<int> empty;
+        ParallelSort(empty);
+        assert(ParallelReduce(empty, 5) == 5);
+    }
+    {
+        // Исключение из порции пробрасывается вызывающему потоку
+        Vector<int> v(1000);
+        try {
+            ParallelForEach(v, [&v](int& x) {
+                if(&x == &v[555]){
+                    throw std::runtime_error("chunk failed");
+                }
+            }, {&pool, 10});
+            assert(false);
+        } catch(const std::runtime_error&){
+        }
+    }
+    {
+        // Вложенный параллельный цикл внутри задачи пула не блокирует его
+        std::atomic<int> total = 0;
+        ParallelFor(8, [&](size_t begin, size_t end) {
+            for(size_t i = begin; i < end; ++i){
+                ParallelFor(100, [&](size_t inner_begin, size_t inner_end) {
+                    total += static_cast<int>(inner_end - inner_begin);
+                }, {&pool, 10});
+            }
+        }, {&pool, 1});
+        assert(total == 800);
+    }
+}
+
+void Test22() {
+    ThreadPool pool(3);
+    const ParallelPolicy policy{{&pool, 100}};
+    {
+        Vector<std::string> strings(5000);
+        for(size_t i = 0; i < strings.Size(); ++i){
+            strings[i] = std::to_string(i) + std::string(20, 'x');
+        }
+        Vector<std::string> copy(strings, policy);
+        assert(copy == strings);
+        copy.Reserve(20'000, policy);
+        assert(copy.Capacity() == 20'000);
+        assert(copy == strings);
+        copy.Resize(12'345, policy);
+        assert(copy.Size() == 12'345 && copy[12'344].empty() && copy[4999] == strings[4999]);
+        copy.Resize(10, policy);
+        assert(copy.Size() == 10 && copy[9] == strings[9]);
+        copy.Clear(policy);
+        assert(copy.Size() == 0 && copy.Capacity() == 20'000);
+    }
+    {
+        Vector<int> zeros(100'000, par);
+        assert(Count(zeros, 0) == zeros.Size());
+        Vector<int> empty(0, policy);
+        assert(empty.Size() == 0);
+    }
+    {
+        // Копирование бросает исключение на одном из элементов
+        struct Tracked {
+            Tracked(std::shared_ptr<int> token, int id)
+            : token(std::move(token)), id(id){}
+            Tracked(const Tracked& other)
+            : token(other.token), id(other.id){
+                if(id == 777){
+                    throw std::runtime_error("copy failed");
+                }
+            }
+            std::shared_ptr<int> token;
+            int id;
+        };
+        const auto token = std::make_shared<int>();
+        Vector<Tracked> tracked;
+        tracked.Reserve(2000);
+        for(int i = 0; i < 2000; ++i){
+            tracked.EmplaceBack(token, i);
+        }
+        assert(token.use_count() == 2001);
+        try {
+            Vector<Tracked> copy(tracked, policy);
+            assert(false);
+        } catch(const std::runtime_error&){
+        }
+        assert(token.use_count() == 2001);
+        try {
+            tracked.Reserve(5000, policy);
+            assert(false);
+        } catch(const std::runtime_error&){
+        }
+        assert(token.use_count() == 2001);
+        assert(tracked.Capacity() == 2000 && tracked[1999].id == 1999);
+    }
+}
+
+void Test23() {
+    {
+        ConcurrentVector<int> v;
+        constexpr int THREADS = 4;
+        constexpr int PER_THREAD = 20'000;
+        Vector<std::thread> writers;
+        for(int t = 0; t < THREADS; ++t){
+            writers.EmplaceBack([&v, t] {
+                for(int i = 0; i < PER_THREAD; ++i){
+                    int& element = v.EmplaceBack(t * PER_THREAD + i);
+                    assert(element == t * PER_THREAD + i);
+                }
+            });
+        }
+        // Опубликованные элементы можно читать, пока другие потоки добавляют новые
+        while(v.Size() < THREADS * PER_THREAD){
+            const size_t size = v.Size();
+            if(size != 0){
+                assert(v[size - 1] >= 0 && v[size - 1] < THREADS * PER_THREAD);
+            }
+        }
+        for(std::thread& writer : writers){
+            writer.join();
+        }
+        const int* first = &v[0];
+        Vector<int> frozen = v.Freeze();
+        assert(v.Size() == 0);
+        assert(frozen.Size() == THREADS * PER_THREAD);
+        assert(first != frozen.begin());
+        std::sort(frozen.begin(), frozen.end());
+        for(size_t i = 0; i < frozen.Size(); ++i){
+            assert(frozen[i] == static_cast<int>(i));
+        }
+    }
+    {
+        ConcurrentVector<std::string> v;
+        v.Reserve(1000);
+        std::string* first = &v.EmplaceBack("first");
+        for(int i = 1; i < 1000; ++i){
+            v.PushBack(std::to_string(i));
+        }
+        // Сегменты не перемещают элементы при росте
+        assert(first == &v[0] && *first == "first");
+        assert(v[999] == "999");
+        Vector<std::string> frozen = v.Freeze();
+        assert(frozen.Size() == 1000 && frozen[0] == "first" && frozen[999] == "999");
+        v.PushBack("again");
+        assert(v.Size() == 1 && v[0] == "again");
+    }
+    {
+        // Исключение в конструкторе не оставляет в векторе пустой ячейки
+        struct ThrowingInt {
+            explicit ThrowingInt(int value)
+            : value(value){
+                if(value < 0){
+                    throw std::invalid_argument("negative");
+                }
+            }
+            int value;
+        };
+        ConcurrentVector<ThrowingInt> v;
+        v.EmplaceBack(1);
+        try {
+            v.EmplaceBack(-1);
+            assert(false);
+        } catch(const std::invalid_argument&){
+        }
+        v.EmplaceBack(2);
+        assert(v.Size() == 2 && v[1].value == 2);
+    }
+    {
+        // После завершения всех потоков опубликованы все добавленные элементы
+        constexpr int THREADS = 4;
+        constexpr int PER_THREAD = 8;
+        for(int round = 0; round < 2000; ++round){
+            ConcurrentVector<int> v;
+            Vector<std::thread> writers;
+            for(int t = 0; t < THREADS; ++t){
+                writers.EmplaceBack([&v] {
+                    for(int i = 0; i < PER_THREAD; ++i){
+                        v.PushBack(i);
+                    }
+                });
+            }
+            for(std::thread& writer : writers){
+                writer.join();
+            }
+            assert(v.Size() == THREADS * PER_THREAD);
+            assert(v.Freeze().Size() == THREADS * PER_THREAD);
+        }
+    }
+}
+
+void Test24() {
+    {
+        SegmentedVector<std::string, 2> v;
+        Vector<const std::string*> addresses;
+        for(int i = 0; i < 1000; ++i){
+            addresses.PushBack(&v.EmplaceBack(std::to_string(i)));
+        }
+        assert(v.Size() == 1000 && v.Capacity() >= 1000);
+        // Рост не перемещает элементы
+        for(size_t i = 0; i < v.Size(); ++i){
+            assert(addresses[i] == &v[i] && v[i] == std::to_string(i));
+        }
+        // Аргумент может ссылаться на элемент самого вектора
+        v.PushBack(v[0]);
+        assert(v[1000] == "0");
+        v.PopBack();
+        assert(std::distance(v.begin(), v.end()) == 1000);
+        assert(std::find(v.begin(), v.end(), "777") - v.begin() == 777);
+        assert(std::is_sorted(v.begin(), v.begin() + 10));
+
+        SegmentedVector<std::string, 2> copy(v);
+        assert(std::equal(copy.begin(), copy.end(), v.begin(), v.end()));
+        const size_t capacity = copy.Capacity();
+        copy.Resize(3);
+        assert(copy.Size() == 3 && copy.Capacity() == capacity);
+        copy = v;
+        assert(copy.Size() == 1000 && copy[999] == "999");
+        SegmentedVector<std::string, 2> moved(std::move(copy));
+        assert(copy.Size() == 0 && moved.Size() == 1000 && &moved[0] != &v[0]);
+        moved = std::move(v);
+        assert(v.Size() == 0 && moved[0] == "0" && &moved[0] == addresses[0]);
+    }
+    {
+        SegmentedVector<int> v{3, 1, 2};
+        std::sort(v.begin(), v.end());
+        const SegmentedVector<int>& cv = v;
+        assert(*cv.begin() == 1 && cv.end()[-1] == 3);
+        SegmentedVector<int>::const_iterator it = v.begin();
+        assert(it == cv.cbegin() && it + 3 == cv.cend());
+        v.Resize(100);
+        assert(v[99] == 0);
+        v.Clear();
+        assert(v.Size() == 0 && v.Capacity() >= 100);
+    }
+}
+
+void Test25() {
+    {
+        IncrementalVector<std::string> v;
+        for(int i = 0; i < 64; ++i){
+            v.PushBack(std::to_string(i));
+        }
+        assert(v.Capacity() == 64 && v.PendingMigration() == 0);
+        // Переполнение буфера переносит по одному элементу на добавление
+        v.PushBack(v[0]);
+        assert(v.Capacity() == 128 && v.PendingMigration() == 63);
+        for(size_t i = 0; i < v.Size(); ++i){
+            assert(v[i] == std::to_string(i == 64 ? 0 : i));
+        }
+        for(int i = 0; i < 10; ++i){
+            v.PushBack("x");
+        }
+        assert(v.PendingMigration() == 53);
+        assert(v[40] == "40" && v[5] == "5" && v[74] == "x");
+        for(int i = 0; i < 53; ++i){
+            v.PushBack("y");
+        }
+        assert(v.PendingMigration() == 0 && v.Size() == 128);
+
+        IncrementalVector<std::string> copy(v);
+        copy.PushBack("z");
+        assert(copy.PendingMigration() == 127 && copy.Size() == 129);
+        // Удаление элементов из непереносённой части
+        while(copy.Size() > 50){
+            copy.PopBack();
+        }
+        assert(copy.PendingMigration() == 49 && copy[49] == "49");
+        copy.PushBack("w");
+        assert(copy.PendingMigration() == 48);
+        // Константный обход читает оба буфера и не завершает перенос
+        const IncrementalVector<std::string>& view = copy;
+        assert(std::distance(view.begin(), view.end()) == 51);
+        assert(std::equal(view.begin(), view.begin() + 50, v.begin()) && *(view.cend() - 1) == "w");
+        assert(std::find(view.cbegin(), view.cend(), "10") - view.cbegin() == 10);
+        assert(copy.PendingMigration() == 48);
+        assert(std::distance(copy.begin(), copy.end()) == 51);
+        assert(copy.PendingMigration() == 0 && copy[50] == "w");
+    }
+    {
+        // Для коэффициента роста 3/2 освобождается около половины старой вместимости,
+        // поэтому шаг переноса - два или три элемента
+        IncrementalVector<int, GrowthFactor<3, 2>> v;
+        for(int i = 0; i < 100; ++i){
+            const size_t pending = v.PendingMigration();
+            v.PushBack(i);
+            assert(pending == 0 || pending - v.PendingMigration() <= 3);
+        }
+        assert(v[0] == 0 && v[99] == 99);
+        v.Reserve(1000);
+        assert(v.Capacity() == 1000 && v.PendingMigration() == 0);
+        assert(v.end() - v.begin() == 100 && v[99] == 99);
+        IncrementalVector<int, GrowthFactor<3, 2>> moved(std::move(v));
+        assert(v.Size() == 0 && moved.Size() == 100);
+    }
+}
+
+void Test26() {
+    using namespace std::literals;
+    {
+        SoaVector<float, int, std::string> particles;
+        for(int i = 0; i < 100; ++i){
+            particles.EmplaceBack(static_cast<float>(i), i * 2, std::to_string(i));
+        }
+        assert(particles.Size() == 100 && particles.Capacity() >= 100);
+        // Поля одного типа лежат непрерывно и доступны векторизованным алгоритмам
+        assert(simd::Sum(particles.Data<1>(), particles.Size()) == 9900);
+        assert(simd::Find(particles.Data<0>(), particles.Size(), 42.0f) == 42);
+
+        auto [x, id, name] = particles[7];
+        assert(x == 7.0f && id == 14 && name == "7"s);
+        std::get<2>(particles[7]) = "seven";
+        name += "!";
+        assert(particles.Data<2>()[7] == "seven!"s);
+
+        particles.Erase(0, 50);
+        assert(particles.Size() == 50 && std::get<1>(particles[0]) == 100);
+        particles.Erase(49);
+        particles.PopBack();
+        assert(particles.Size() == 48 && std::get<2>(particles[47]) == "97"s);
+
+        // Аргументы могут ссылаться на поля вектора, который растёт
+        while(particles.Size() != particles.Capacity()){
+            particles.PushBack(1.0f, 1, "x"s);
+        }
+        particles.EmplaceBack(particles.Data<0>()[0], std::get<1>(particles[0]), std::get<2>(particles[0]));
+        assert(std::get<2>(particles[particles.Size() - 1]) == "50"s);
+
+        const SoaVector<float, int, std::string> copy(particles);
+        assert(copy.Size() == particles.Size() && std::get<2>(copy[0]) == "50"s);
+        particles.Resize(200);
+        assert(std::get<0>(particles[199]) == 0.0f && std::get<2>(particles[199]).empty());
+        SoaVector<float, int, std::string> moved(std::move(particles));
+        assert(particles.Size() == 0 && moved.Size() == 200);
+        particles = copy;
+        assert(particles.Size() == copy.Size());
+    }
+    {
+        // Исключение при копировании поля оставляет вектор без изменений
+        struct ThrowingCopy {
+            explicit ThrowingCopy(const bool* fail)
+            : fail(fail){}
+            ThrowingCopy(const ThrowingCopy& other)
+            : fail(other.fail){
+                if(*fail){
+                    throw std::runtime_error("copy failed");
+                }
+            }
+            ThrowingCopy& operator=(const ThrowingCopy&) = default;
+            const bool* fail;
+        };
+        bool fail = false;
+        SoaVector<std::string, ThrowingCopy> v;
+        v.EmplaceBack("a"s, &fail);
+        fail = true;
+        try {
+            v.Reserve(10);
+            assert(false);
+        } catch(const std::runtime_error&){
+        }
+        try {
+            v.EmplaceBack("b"s, &fail);
+            assert(false);
+        } catch(const std::runtime_error&){
+        }
+        fail = false;
+        assert(v.Size() == 1 && v.Capacity() == 1 && std::get<0>(v[0]) == "a"s);
+    }
+}
+
+void Test27() {
+    const size_t SIZE = 10;
+    {
+        // Вставка в середину присваивает значение на место без промежуточной копии
+        Vector<Obj> v(SIZE);
+        v.Reserve(SIZE * 2);
+        Obj obj(42);
+        Obj::ResetCounters();
+        auto pos = v.Insert(v.cbegin() + 3, obj);
+        assert(pos == v.begin() + 3 && v[3].id == 42 && obj.id == 42);
+        assert(Obj::num_copied == 0 && Obj::num_assigned == 1);
+        assert(Obj::num_moved == 1 && Obj::num_move_assigned == SIZE - 4);
+        assert(Obj::num_destroyed == 0);
+
+        Obj::ResetCounters();
+        v.Insert(v.cbegin() + 1, Obj(7));
+        assert(v[1].id == 7 && v[4].id == 42);
+        assert(Obj::num_copied == 0 && Obj::num_moved == 1 && Obj::num_move_assigned == SIZE + 1 - 1);
+    }
+    {
+        // Значение из самого вектора копируется до сдвига элементов
+        using namespace std::literals;
+        Vector<std::string> v{"a"s, "b"s, "c"s};
+        v.Reserve(10);
+        v.Insert(v.cbegin(), v[2]);
+        v.Insert(v.cbegin() + 1, std::move(v[3]));
+        assert((v == Vector<std::string>{"c"s, "c"s, "a"s, "b"s, ""s}));
+        v.Emplace(v.cbegin() + 2, 3, 'x');
+        assert(v[2] == "xxx"s && v.Size() == 6);
+    }
+    {
+        // Исключение при копирующем присваивании возвращает элементы на место
+        struct ThrowingAssign {
+            int id = 0;
+            ThrowingAssign() = default;
+            explicit ThrowingAssign(int id)
+            : id(id){}
+            ThrowingAssign(const ThrowingAssign&) = default;
+            ThrowingAssign(ThrowingAssign&&) noexcept = default;
+            ThrowingAssign& operator=(ThrowingAssign&&) noexcept = default;
+            ThrowingAssign& operator=(const ThrowingAssign& other){
+                if(other.id < 0){
+                    throw std::runtime_error("assign failed");
+                }
+                id = other.id;
+                return *this;
+            }
+        };
+        Vector<ThrowingAssign> v;
+        v.Reserve(10);
+        for(int i = 0; i < 5; ++i){
+            v.EmplaceBack(i);
+        }
+        const ThrowingAssign bad(-1);
+        try {
+            v.Insert(v.cbegin() + 2, bad);
+            assert(false);
+        } catch(const std::runtime_error&){
+        }
+        assert(v.Size() == 5);
+        for(int i = 0; i < 5; ++i){
+            assert(v[i].id == i);
+        }
+    }
+}
+
+void Test28() {
+    using namespace std::literals;
+    {
+        // Поиск без ветвлений совпадает с std::lower_bound на всех позициях
+        Vector<int> sorted;
+        for(int i = 0; i < 100; ++i){
+            sorted.PushBack(i / 3 * 2);
+        }
+        for(size_t size = 0; size <= sorted.Size(); ++size){
+            for(int key = -1; key <= 70; ++key){
+                assert(BranchlessLowerBound(sorted.begin(), size, key, std::less<>{})
+                       == std::lower_bound(sorted.begin(), sorted.begin() + size, key));
+            }
+        }
+    }
+    {
+        FlatSet<int> set{5, 1, 3, 3, 9};
+        assert(set.Size() == 4);
+        assert(std::is_sorted(set.begin(), set.end()));
+        assert(set.Contains(3) && !set.Contains(4));
+        assert(set.Insert(4).second && !set.Insert(4).second);
+        assert(*set.LowerBound(6) == 9 && *set.UpperBound(4) == 5);
+        const Vector<int> more{0, 2, 3, 10, 10};
+        set.InsertSorted(more);
+        assert((set.GetData() == Vector<int>{0, 1, 2, 3, 4, 5, 9, 10}));
+        const std::vector<int> unsorted{8, -1, 8, 6};
+        set.Insert(unsorted.begin(), unsorted.end());
+        assert((set.GetData() == Vector<int>{-1, 0, 1, 2, 3, 4, 5, 6, 8, 9, 10}));
+        assert(set.Erase(5) == 1 && set.Erase(5) == 0);
+        assert(set.Find(5) == set.end() && set.Count(6) == 1);
+    }
+    {
+        FlatSet<std::string, std::greater<>> set{"b"s, "c"s, "a"s};
+        assert(*set.begin() == "c"s && *(set.end() - 1) == "a"s);
+    }
+    {
+        FlatMap<std::string, int> map{{"one"s, 1}, {"two"s, 2}, {"one"s, 100}};
+        assert(map.Size() == 2 && map.At("one"s) == 1);
+        map["three"s] = 3;
+        ++map["one"s];
+        assert(map.At("one"s) == 2 && map.Size() == 3);
+        assert(!map.InsertOrAssign("two"s, 20).second && map.At("two"s) == 20);
+        assert(map.InsertOrAssign("zero"s, 0).second);
+        Vector<std::pair<std::string, int>> batch;
+        batch.PushBack({"four"s, 4});
+        batch.PushBack({"one"s, -1});
+        batch.PushBack({"six"s, 6});
+        map.InsertSorted(batch);
+        assert(map.Size() == 6 && map.At("one"s) == 2 && map.At("six"s) == 6);
+        assert(map.Find("four"s)->second == 4);
+        map.Find("four"s)->second = 44;
+        assert(map.At("four"s) == 44);
+        try {
+            map.At("missing"s);
+            assert(false);
+        } catch(const std::out_of_range&){
+        }
+        const auto& cmap = map;
+        assert(cmap.Find("missing"s) == cmap.end());
+        std::string keys;
+        for(const auto& [key, value] : cmap){
+            keys += key + ",";
+        }
+        assert(keys == "four,one,six,three,two,zero,"s);
+    }
+}
+
+void Test29() {
+    using namespace std::literals;
+    {
+        // Очередь FIFO: голова обходит буфер по кругу, не вызывая перевыделений
+        RingVector<int> queue;
+        queue.Reserve(5);
+        assert(queue.Capacity() == 8);
+        for(int i = 0; i < 100; ++i){
+            queue.PushBack(i);
+            if(queue.Size() == 6){
+                for(int j = 0; j < 4; ++j){
+                    queue.PopFront();
+                }
+            }
+        }
+        assert(queue.Capacity() == 8);
+        assert(queue.Front() == 96 && queue.Back() == 99 && queue.Size() == 4);
+    }
+    {
+        // Рост разворачивает кольцо, сохраняя порядок элементов
+        RingVector<std::string> ring;
+        for(int i = 0; i < 4; ++i){
+            ring.PushBack(std::to_string(i));
+        }
+        ring.PopFront();
+        ring.PopFront();
+        ring.PushBack("4"s);
+        ring.PushBack("5"s);
+        ring.PushFront("1"s);
+        assert(ring.Capacity() == 8 && ring.Size() == 5);
+        ring.PushFront(ring.Back());
+        ring.PushFront("-"s);
+        assert(ring.Size() == 7);
+        std::string joined;
+        for(const std::string& value : ring){
+            joined += value;
+        }
+        assert(joined == "-512345"s);
+        ring.PopBack();
+        ring.PopFront();
+        assert(ring[0] == "5"s && ring[4] == "4"s);
+        const RingVector<std::string> copy(ring);
+        assert(std::equal(copy.begin(), copy.end(), ring.begin(), ring.end()));
+    }
+    {
+        // Рост при добавлении в начало: новый элемент ложится в конец нового буфера
+        RingVector<int> ring{1, 2};
+        ring.PushFront(0);
+        ring.PushFront(-1);
+        ring.PushFront(-2);
+        assert(ring.Capacity() == 8);
+        assert((std::vector<int>(ring.begin(), ring.end()) == std::vector<int>{-2, -1, 0, 1, 2}));
+        std::sort(ring.begin(), ring.end(), std::greater<>{});
+        assert(ring.Front() == 2 && ring.Back() == -2);
+    }
+    {
+        // Если перенос при росте бросил исключение, кольцо не меняется
+        struct Fragile {
+            Fragile(int value, const bool* fail)
+            : value(value), fail(fail){}
+
+            Fragile(const Fragile& other)
+            : value(other.value), fail(other.fail){
+                if(*fail){
+                    throw std::runtime_error("copy");
+                }
+            }
+
+            int value;
+            const bool* fail;
+        };
+        bool fail = false;
+        RingVector<Fragile> ring;
+        for(int i = 0; i < 4; ++i){
+            ring.EmplaceBack(i, &fail);
+        }
+        ring.PopFront();
+        ring.EmplaceBack(4, &fail);
+        fail = true;
+        try {
+            ring.EmplaceFront(0, &fail);
+            assert(false);
+        } catch(const std::runtime_error&){
+        }
+        assert(ring.Size() == 4 && ring.Capacity() == 4);
+        for(size_t i = 0; i < ring.Size(); ++i){
+            assert(ring[i].value == static_cast<int>(i) + 1);
+        }
+    }
+}
+
+void Test30() {
+    using namespace std::literals;
+    {
+        SpscQueue<std::string> queue(3);
+        assert(queue.Capacity() == 4 && queue.IsEmpty());
+        std::string value;
+        assert(!queue.TryPop(value));
+        for(int i = 0; i < 4; ++i){
+            assert(queue.TryPush(std::to_string(i)));
+        }
+        assert(!queue.TryPush("overflow"s) && queue.Size() == 4);
+        assert(queue.TryPop(value) && value == "0"s);
+        // Пакет переходит через конец буфера
+        const std::string batch[] = {"a"s, "b"s, "c"s};
+        assert(queue.TryPushN(batch, 3) == 1);
+        std::vector<std::string> popped(5);
+        assert(queue.TryPopN(popped.begin(), popped.size()) == 4);
+        assert((popped == std::vector<std::string>{"1"s, "2"s, "3"s, "a"s, ""s}));
+        assert(queue.TryPushN(batch, 3) == 3 && queue.TryEmplace(2, 'z'));
+        // Оставшиеся элементы уничтожаются деструктором очереди
+    }
+    {
+        // Производитель и потребитель в разных потоках: порядок и значения сохраняются
+        constexpr int COUNT = 200000;
+        SpscQueue<int> queue(256);
+        std::thread producer([&queue] {
+            int batch[7];
+            for(int next = 0; next < COUNT;){
+                if(next % 3 == 0){
+                    const int size = std::min(7, COUNT - next);
+                    std::iota(batch, batch + size, next);
+                    next += static_cast<int>(queue.TryPushN(batch, size));
+                } else if(queue.TryPush(next)){
+                    ++next;
+                }
+            }
+        });
+        int expected = 0;
+        int buffer[16];
+        while(expected < COUNT){
+            const size_t count = queue.TryPopN(buffer, 16);
+            for(size_t i = 0; i < count; ++i){
+                assert(buffer[i] == expected);
+                ++expected;
+            }
+            int single;
+            if(queue.TryPop(single)){
+                assert(single == expected);
+                ++expected;
+            }
+        }
+        producer.join();
+        assert(queue.IsEmpty());
+    }
+}
+
+void Test31() {
+    {
+        // Буферы, освобождённые при росте и разрушении векторов, переиспользуются
+        SizeClassPool::TrimThreadCache();
+        SizeClassPool::ResetThreadStats();
+        for(int round = 0; round < 10; ++round){
+            PoolVector<int> v;
+            for(int i = 0; i < 1000; ++i){
+                v.PushBack(i);
+            }
+            assert(v[999] == 999);
+        }
+        const PoolStats stats = SizeClassPool::GetThreadStats();
+        // Промахи возможны только в первом раунде, по одному на класс размеров
+        assert(stats.misses <= 11 && stats.hits >= 9 * 11);
+        assert(stats.HitRate() > 0.9);
+    }
+    {
+        // Блок, освобождённый другим потоком, возвращается владельцу
+        SizeClassPool::TrimThreadCache();
+        SizeClassPool::ResetThreadStats();
+        auto* v = new PoolVector<std::string>(100);
+        std::thread([v] {
+            delete v;
+        }).join();
+        PoolVector<std::string> reused(100);
+        assert(SizeClassPool::GetThreadStats().remote_frees == 1);
+        assert(SizeClassPool::GetThreadStats().hits == 1);
+    }
+    {
+        // Большие буферы идут мимо пула
+        SizeClassPool::ResetThreadStats();
+        PoolVector<char> large(SizeClassPool::MAX_BLOCK_SIZE + 1);
+        assert(SizeClassPool::GetThreadStats().misses == 0);
+        static_assert(SizeClassPool::SizeClassOf(1) == 0 && SizeClassPool::SizeClassOf(17) == 1);
+    }
+}
+
+void Test32() {
+    using namespace std::literals;
+    {
+        SharedVector<std::string> original{"a"s, "b"s, "c"s};
+        const SharedVector<std::string> snapshot = original;
+        assert(original.UseCount() == 2 && snapshot.begin() == original.begin());
+        // Чтение через константный интерфейс не отделяет копию
+        const auto& view = original;
+        assert(view[1] == "b"s && original.IsShared());
+        original[1] = "B"s;
+        assert(!original.IsShared() && !snapshot.IsShared());
+        assert(snapshot[1] == "b"s && original[1] == "B"s);
+        // Собственный буфер изменяется на месте
+        const std::string* data = original.begin();
+        original[0] = "A"s;
+        assert(original.begin() == data);
+    }
+    {
+        SharedVector<std::string> v{"x"s, "y"s};
+        SharedVector<std::string> copy = v;
+        // Аргумент ссылается на элемент разделённого буфера
+        v.PushBack(v[0]);
+        v.Insert(v.begin() + 1, copy[1]);
+        assert((v.Mutable() == Vector<std::string>{"x"s, "y"s, "y"s, "x"s}));
+        assert(copy.Size() == 2 && copy.UseCount() == 1);
+        SharedVector<std::string> erased = copy;
+        erased.Erase(erased.begin());
+        assert(erased.Size() == 1 && erased[0] == "y"s && copy.Size() == 2);
+        erased = copy;
+        erased.Clear();
+        assert(erased.IsEmpty() && copy.Size() == 2 && copy.UseCount() == 1);
+        SharedVector<std::string> empty;
+        empty.PushBack("z"s);
+        empty.PopBack();
+        assert(empty.IsEmpty() && empty.Capacity() == 1);
+    }
+    {
+        // Копия, снятая после выдачи изменяемой ссылки, не видит записей через неё
+        SharedVector<int> a{1, 2, 3};
+        int& r = a[0];
+        SharedVector<int> b = a;
+        r = 42;
+        assert(a[0] == 42 && b[0] == 1);
+        assert(a.UseCount() == 1 && b.UseCount() == 1);
+        // Перевыделение инвалидирует ссылку, и буфер снова разделяется
+        a.Reserve(100);
+        SharedVector<int> c = a;
+        assert(c.UseCount() == 2 && c.begin() == a.begin());
+        Vector<int>& data = c.Mutable();
+        SharedVector<int> d = c;
+        data.PushBack(4);
+        assert(c.Size() == 4 && d.Size() == 3 && a.Size() == 3);
+        // Ссылка из Mutable() остаётся действительной и после перевыделения
+        SharedVector<int> e{1, 2, 3};
+        Vector<int>& m = e.Mutable();
+        e.PushBack(4);
+        SharedVector<int> snapshot = e;
+        m[0] = 42;
+        assert(e[0] == 42 && snapshot[0] == 1);
+        assert(e.UseCount() == 1 && snapshot.UseCount() == 1);
+    }
+    {
+        // Снимки передаются в потоки без копирования элементов
+        SharedVector<int> config(Vector<int>(1000));
+        std::vector<std::thread> workers;
+        std::vector<long> sums(4);
+        for(size_t i = 0; i < sums.size(); ++i){
+            workers.emplace_back([snapshot = config, &sum = sums[i], i]() mutable {
+                sum = std::accumulate(snapshot.begin(), snapshot.end(), 0L);
+                snapshot[0] = static_cast<int>(i) + 1;
+                sum += snapshot[0];
+            });
+        }
+        config[0] = -1;
+        for(std::thread& worker : workers){
+            worker.join();
+        }
+        assert((sums == std::vector<long>{1, 2, 3, 4}));
+        assert(config[0] == -1 && config.UseCount() == 1);
+    }
+}
+
+void Test33() {
+    using namespace std::literals;
+    static_assert(std::is_trivially_copyable_v<VectorView<const int>>);
+    {
+        constexpr static int ARRAY[] = {1, 2, 3, 4, 5};
+        constexpr VectorView<const int> view(ARRAY);
+        static_assert(view.Size() == 5 && view.Subspan(1, 3).Front() == 2 && view.Last(2)[0] == 4);
+        static_assert(view.Subspan(5).IsEmpty() && view.First(0).IsEmpty());
+    }
+    {
+        Vector<int> v(100);
+        std::iota(v.begin(), v.end(), 0);
+        // Срез передаётся алгоритмам без копирования
+        const VectorView<int> middle = VectorView(v).Subspan(10, 20);
+        assert(middle.Data() == v.begin() + 10 && middle.Size() == 20);
+        assert(Sum(middle) == (10 + 29) * 10);
+        assert((MinMax(middle) == std::pair{10, 29}));
+        assert(Find(middle, 15) == v.begin() + 15 && Find(middle, 5) == middle.end());
+        assert(Contains(middle, 29) && !Contains(middle, 30) && Count(middle, 12) == 1);
+        Fill(middle.First(5), -1);
+        assert(v[9] == 9 && v[10] == -1 && v[14] == -1 && v[15] == 15);
+        // Изменяемое представление приводится к константному
+        const VectorView<const int> read_only = middle;
+        assert(Equal(read_only.First(5), VectorView<const int>(v).Subspan(10, 5)));
+        assert(!Equal(read_only, VectorView(v)));
+    }
+    {
+        const std::vector<std::string> words{"alpha"s, "beta"s, "gamma"s};
+        const VectorView view(words);
+        static_assert(std::is_same_v<decltype(view), const VectorView<const std::string>>);
+        assert(Count(view.Subspan(1), "beta"s) == 1);
+        std::string joined;
+        for(const std::string& word : view.Last(2)){
+            joined += word;
+        }
+        assert(joined == "betagamma"s);
+        double values[] = {0.5, 1.5, 2.0};
+        assert(Sum(VectorView(values)) == 4.0);
+    }
+}
+
+// Таблица квадратов, построенная во время компиляции
+constexpr StaticVector<int, 16> MakeSquares() {
+    StaticVector<int, 16> squares;
+    for(int i = 0; i < 10; ++i){
+        squares.PushBack(i * i);
+    }
+    squares.Insert(squares.begin(), -1);
+    squares.Erase(squares.begin() + 1);
+    return squares;
+}
+
+#if VECTOR_HAS_CONSTEXPR_ALLOCATION
+// В C++20 Vector работает во время компиляции, но его память должна быть
+// освобождена до конца вычисления, поэтому наружу выходит только результат
+constexpr int SumOfPrimesBelow(int limit) {
+    Vector<int> primes;
+    for(int n = 2; n < limit; ++n){
+        bool is_prime = true;
+        for(const int p : primes){
+            is_prime = is_prime && n % p != 0;
+        }
+        if(is_prime){
+            primes.EmplaceBack(n);
+        }
+    }
+    primes.Insert(primes.begin(), primes[1]);
+    primes.Erase(primes.begin());
+    Vector<int> copy(primes);
+    int sum = 0;
+    for(const int p : copy){
+        sum += p;
+    }
+    return sum;
+}
+#endif
+
+void Test34() {
+    using namespace std::literals;
+    {
+        constexpr StaticVector<int, 16> SQUARES = MakeSquares();
+        static_assert(SQUARES.Size() == 10 && SQUARES[0] == -1 && SQUARES[9] == 81);
+        static_assert(StaticVector<char, 4>{'a', 'b'}.Size() == 2);
+#if VECTOR_HAS_CONSTEXPR_ALLOCATION
+        static_assert(SumOfPrimesBelow(30) == 129);
+#endif
+    }
+    {
+        StaticVector<std::string, 4> v{"b"s, "c"s};
+        v.Insert(v.begin(), v[1]);
+        v.EmplaceBack(2, 'd');
+        assert(v.Size() == 4 && v[0] == "c"s && v[3] == "dd"s);
+        try {
+            v.PushBack("overflow"s);
+            assert(false);
+        } catch(const std::length_error&){
+        }
+        assert(v.Size() == 4);
+        StaticVector<std::string, 4> other(v);
+        other.Erase(other.begin(), other.begin() + 3);
+        assert(other.Size() == 1 && other[0] == "dd"s);
+        v.Swap(other);
+        assert(v.Size() == 1 && other.Size() == 4 && other[1] == "b"s);
+        other = v;
+        assert(other.Size() == 1 && other[0] == "dd"s);
+        other.Resize(3);
+        assert(other[2].empty());
+        other.PopBack();
+        other.Clear();
+        assert(other.Size() == 0);
+    }
+    Obj::ResetCounters();
+    {
+        // Исключение при копировании третьего элемента не оставляет живых копий
+        StaticVector<Obj, 4> v;
+        v.Resize(4);
+        v[2].throw_on_copy = true;
+        try {
+            StaticVector<Obj, 4> v_copy(v);
+            assert(false && "Exception is expected");
+        } catch(const std::runtime_error&){
+            assert(Obj::num_copied == 2);
+        }
+        assert(Obj::GetAliveObjectCount() == 4);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+// Тип, конструктор по умолчанию которого бросает исключение на заданном номере
+struct NumaCounted {
+    NumaCounted() {
+        if (++constructed == throw_at) {
+            throw std::runtime_error("Oops");
+        }
+        ++alive;
+    }
+
+    ~NumaCounted() {
+        --alive;
+    }
+
+    static inline std::atomic<int> constructed = 0;
+    static inline std::atomic<int> alive = 0;
+    static inline int throw_at = 0;
+};
+
+void Test35() {
+    const size_t node_count = NumaNodeCount();
+    assert(node_count >= 1);
+    assert(NumaNodeCpus(0).Size() != 0);
+    assert(CurrentNumaNode() >= 0 && static_cast<size_t>(CurrentNumaNode()) < node_count);
+    {
+        const Vector<int> list = detail::ParseNumaList("0-2,5,7-8");
+        assert(list.Size() == 6 && list[2] == 2 && list[3] == 5 && list[5] == 8);
+        assert(detail::ParseNumaList("").Size() == 0);
+    }
+    {
+        // Страницы нового буфера не отображены, пока в них никто не писал
+        NumaAllocator<int> alloc(NumaPolicy{NumaPlacement::BIND, 0});
+        const size_t count = NumaAllocator<int>::MMAP_THRESHOLD;
+        int* const buffer = alloc.allocate(count);
+        assert(NumaNodeOf(buffer) == NUMA_NO_NODE);
+        buffer[0] = 1;
+        const int node = NumaNodeOf(buffer);
+        assert(node == NUMA_NO_NODE || node == 0);
+        const Vector<int> pages = NumaPageNodes(buffer, count * sizeof(int));
+        assert(pages.Size() >= count * sizeof(int) / 4096 / 2);
+        assert(pages[0] == node);
+        alloc.deallocate(buffer, count);
+        try {
+            alloc.allocate(std::numeric_limits<size_t>::max() / sizeof(int) + 1);
+            assert(false);
+        } catch(const std::bad_array_new_length&){
+        }
+    }
+    {
+        NumaVector<int> v(NumaAllocator<int>(NumaPolicy{NumaPlacement::INTERLEAVE}));
+        for(int i = 0; i < 100000; ++i){
+            v.PushBack(i);
+        }
+        for(const int node : NumaPageNodes(v.begin(), v.Size() * sizeof(int))){
+            assert(node == NUMA_NO_NODE || static_cast<size_t>(node) < node_count);
+        }
+        NumaVector<int> copy(v);
+        assert(copy.GetAllocator() == v.GetAllocator());
+        assert(copy.GetAllocator().Policy().placement == NumaPlacement::INTERLEAVE);
+        NumaVector<int> small;
+        small = std::move(copy);
+        assert(small.Size() == 100000 && small[99999] == 99999);
+        assert(small.GetAllocator().Policy().placement == NumaPlacement::INTERLEAVE);
+    }
+    NumaThreadPools pools(2);
+    assert(pools.NodeCount() == node_count && pools.ThreadCount() == 2 * node_count);
+    const NumaParallelPolicy policy{{&pools, 1000}};
+    {
+        // Первое касание порций выполняется потоками их узлов
+        NumaVector<std::atomic<int>> v(100000, policy);
+        policy.For(v.Size(), [&v](size_t begin, size_t end) {
+            for(size_t i = begin; i < end; ++i){
+                v[i] = static_cast<int>(i);
+            }
+        });
+        std::atomic<long long> sum = 0;
+        NumaParallelFor(v.begin(), v.Size(), [&v, &sum](size_t begin, size_t end) {
+            long long local = 0;
+            for(size_t i = begin; i < end; ++i){
+                local += v[i];
+            }
+            sum += local;
+        }, {&pools, 4096});
+        assert(sum == 99999LL * 100000 / 2);
+    }
+    {
+        NumaVector<int> v;
+        v.Resize(50000, policy);
+        assert(v.Size() == 50000 && std::all_of(v.begin(), v.end(), [](int x) { return x == 0; }));
+        NumaParallelForEach(v, [](int& x) { x = 3; }, {&pools});
+        std::atomic<int> sum = 0;
+        const NumaVector<int>& cv = v;
+        NumaParallelForEach(cv, [&sum](int x) { sum += x; }, {&pools});
+        assert(sum == 150000);
+        v.Reserve(200000, policy);
+        v.Clear(policy);
+        assert(v.Size() == 0 && v.Capacity() == 200000);
+    }
+    {
+        NumaCounted::throw_at = 5000;
+        try {
+            Vector<NumaCounted> v(10000, policy);
+            assert(false);
+        } catch(const std::runtime_error&){
+        }
+        assert(NumaCounted::alive == 0);
+        NumaCounted::throw_at = 0;
+    }
+    {
+        std::atomic<int> chunks = 0;
+        Vector<int> data(100000);
+        try {
+            NumaParallelFor(data.begin(), data.Size(), [&chunks](size_t begin, size_t) {
+                ++chunks;
+                if(begin == 50000){
+                    throw std::runtime_error("Oops");
+                }
+            }, {&pools, 1000});
+            assert(false);
+        } catch(const std::runtime_error&){
+        }
+        assert(chunks <= 100);
+    }
+    {
+        // Вложенный NumaParallelFor в единственном рабочем потоке узла не блокируется
+        NumaThreadPools single(1);
+        Vector<int> data(64);
+        std::atomic<int> inner = 0;
+        NumaParallelFor(data.begin(), data.Size(), [&](size_t, size_t) {
+            NumaParallelFor(data.begin(), data.Size(), [&inner](size_t begin, size_t end) {
+                inner += static_cast<int>(end - begin);
+            }, {&single, 8});
+        }, {&single, 8});
+        assert(inner == 64 * 8);
+    }
+}
+
 struct C {
     C() noexcept {
         ++def_ctor;
@@ -657,6 +2692,35 @@ int main() {
         Test4();
         Test5();
         Test6();
+        Test7();
+        Test8();
+        Test9();
+        Test10();
+        Test11();
+        Test12();
+        Test13();
+        Test14();
+        Test15();
+        Test16();
+        Test17();
+        Test18();
+        Test19();
+        Test20();
+        Test21();
+        Test22();
+        Test23();
+        Test24();
+        Test25();
+        Test26();
+        Test27();
+        Test28();
+        Test29();
+        Test30();
+        Test31();
+        Test32();
+        Test33();
+        Test34();
+        Test35();
         Benchmark();
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
@@ -0,0 +1,289 @@
+#pragma once
+#include "vector.h"
+
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Вектор тривиально копируемых элементов, хранящихся в отображённом в память файле.
+// Файл начинается с заголовка (сигнатура, версия, размер элемента, число элементов),
+// за которым следуют сами элементы; длина файла определяет вместимость.
+// Открытие существующего файла не копирует данные: элементы подгружаются
+// из страничного кэша по мере обращения к ним
+template <typename T, typename GrowthPolicy = DoublingGrowth>
+class MappedVector {
+    static_assert(std::is_trivially_copyable_v<T>, "MappedVector requires a trivially copyable type");
+    static_assert(alignof(T) <= 64, "Element alignment must not exceed the header size");
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    static constexpr uint64_t MAGIC = 0x524f544345564d41;  // "AMVECTOR"
+    static constexpr uint32_t VERSION = 1;
+
+    MappedVector() noexcept = default;
+
+    // Открывает файл path или создаёт пустой, если его нет
+    explicit MappedVector(const std::string& path){
+        fd_ = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if(fd_ < 0){
+            ThrowSystemError("Unable to open " + path);
+        }
+        try {
+            struct stat file_stat{};
+            if(fstat(fd_, &file_stat) != 0){
+                ThrowSystemError("Unable to stat " + path);
+            }
+            const size_t file_size = static_cast<size_t>(file_stat.st_size);
+            if(file_size == 0){
+                Truncate(HEADER_SIZE);
+                Map(HEADER_SIZE);
+                *GetHeader() = Header{MAGIC, VERSION, sizeof(T), 0};
+            } else {
+                if(file_size < HEADER_SIZE){
+                    throw std::runtime_error(path + " is not a MappedVector file");
+                }
+                Map(file_size);
+                const Header& header = *GetHeader();
+                if(header.magic != MAGIC || header.version != VERSION){
+                    throw std::runtime_error(path + " is not a MappedVector file");
+                }
+                if(header.element_size != sizeof(T)){
+                    throw std::runtime_error(path + " stores elements of a different size");
+                }
+            }
+            capacity_ = (mapped_size_ - HEADER_SIZE) / sizeof(T);
+            // Усечённый или повреждённый файл иначе привёл бы к обращениям за границу отображения
+            if(GetHeader()->size > capacity_){
+                throw std::runtime_error(path + " is truncated or corrupt");
+            }
+        } catch(...){
+            Close();
+            throw;
+        }
+    }
+
+    MappedVector(const MappedVector&) = delete;
+    MappedVector& operator=(const MappedVector&) = delete;
+
+    MappedVector(MappedVector&& other) noexcept {
+        Swap(other);
+    }
+
+    MappedVector& operator=(MappedVector&& rhs) noexcept {
+        if(this != &rhs){
+            Close();
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    ~MappedVector(){
+        Close();
+    }
+
+    bool IsOpen() const noexcept {
+        return mapping_ != nullptr;
+    }
+
+    size_t Size() const noexcept {
+        return IsOpen() ? GetHeader()->size : 0;
+    }
+
+    size_t Capacity() const noexcept {
+        return capacity_;
+    }
+
+    // Изменяющие размер методы закрытого (например, перемещённого) вектора бросают std::logic_error
+    void Reserve(size_t new_capacity){
+        CheckOpen();
+        if(new_capacity <= capacity_){
+            return;
+        }
+
+        const size_t new_size = HEADER_SIZE + new_capacity * sizeof(T);
+        Truncate(new_size);
+        Remap(new_size);
+        capacity_ = new_capacity;
+    }
+
+    void Resize(size_t new_size){
+        CheckOpen();
+        const size_t old_size = Size();
+        if(new_size > old_size){
+            Reserve(new_size);
+            std::memset(static_cast<void*>(begin() + old_size), 0, (new_size - old_size) * sizeof(T));
+        }
+        GetHeader()->size = new_size;
+    }
+
+    void PushBack(const T& value){
+        EmplaceBack(value);
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... ctor_args){
+        CheckOpen();
+        const size_t size = Size();
+        if(size == capacity_){
+            // Аргументы могут ссылаться на элементы, которые переедут при mremap
+            T value(std::forward<Args>(ctor_args)...);
+            Reserve(GrowthPolicy::NextCapacity(capacity_, sizeof(T)));
+            new (begin() + size) T(value);
+        } else {
+            new (begin() + size) T(std::forward<Args>(ctor_args)...);
+        }
+        GetHeader()->size = size + 1;
+        return begin()[size];
+    }
+
+    void PopBack() noexcept {
+        assert(Size() != 0);
+        --GetHeader()->size;
+    }
+
+    void Clear() noexcept {
+        if(IsOpen()){
+            GetHeader()->size = 0;
+        }
+    }
+
+    // Синхронно записывает изменения на диск
+    void Flush(){
+        if(IsOpen() && msync(mapping_, mapped_size_, MS_SYNC) != 0){
+            ThrowSystemError("msync failed");
+        }
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<MappedVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < Size());
+        return begin()[index];
+    }
+
+    iterator begin() noexcept {
+        return IsOpen() ? std::launder(reinterpret_cast<T*>(static_cast<char*>(mapping_) + HEADER_SIZE)) : nullptr;
+    }
+
+    iterator end() noexcept {
+        return begin() + Size();
+    }
+
+    const_iterator begin() const noexcept {
+        return const_cast<MappedVector&>(*this).begin();
+    }
+
+    const_iterator end() const noexcept {
+        return begin() + Size();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    void Swap(MappedVector& other) noexcept {
+        std::swap(fd_, other.fd_);
+        std::swap(mapping_, other.mapping_);
+        std::swap(mapped_size_, other.mapped_size_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+private:
+    struct Header {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t element_size;
+        uint64_t size;
+    };
+
+    // Элементы начинаются с границы строки кэша
+    static constexpr size_t HEADER_SIZE = 64;
+    static_assert(sizeof(Header) <= HEADER_SIZE);
+
+    [[noreturn]] static void ThrowSystemError(const std::string& what){
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    void CheckOpen() const {
+        if(!IsOpen()){
+            throw std::logic_error("MappedVector is not open");
+        }
+    }
+
+    Header* GetHeader() noexcept {
+        return static_cast<Header*>(mapping_);
+    }
+
+    const Header* GetHeader() const noexcept {
+        return static_cast<const Header*>(mapping_);
+    }
+
+    void Truncate(size_t size){
+        if(ftruncate(fd_, static_cast<off_t>(size)) != 0){
+            ThrowSystemError("ftruncate failed");
+        }
+    }
+
+    void Map(size_t size){
+        void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if(mapping == MAP_FAILED){
+            ThrowSystemError("mmap failed");
+        }
+        mapping_ = mapping;
+        mapped_size_ = size;
+    }
+
+    void Remap(size_t new_size){
+#if defined(__linux__)
+        void* mapping = mremap(mapping_, mapped_size_, new_size, MREMAP_MAYMOVE);
+        if(mapping == MAP_FAILED){
+            ThrowSystemError("mremap failed");
+        }
+        mapping_ = mapping;
+        mapped_size_ = new_size;
+#else
+        void* old_mapping = mapping_;
+        const size_t old_size = mapped_size_;
+        Map(new_size);
+        munmap(old_mapping, old_size);
+#endif
+    }
+
+    void Close() noexcept {
+        if(mapping_ != nullptr){
+            munmap(mapping_, mapped_size_);
+            mapping_ = nullptr;
+            mapped_size_ = 0;
+        }
+        if(fd_ >= 0){
+            close(fd_);
+            fd_ = -1;
+        }
+        capacity_ = 0;
+    }
+
+    int fd_ = -1;
+    void* mapping_ = nullptr;
+    size_t mapped_size_ = 0;
+    size_t capacity_ = 0;
+};
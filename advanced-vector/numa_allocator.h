@@ -0,0 +1,552 @@
+#pragma once
+#include "parallel.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Узел не определён: страница ещё не отображена в память или ядро не поддерживает NUMA
+inline constexpr int NUMA_NO_NODE = -1;
+
+namespace detail {
+
+// Разбирает список вида "0-3,8,10-11" из /sys/devices/system/node
+inline Vector<int> ParseNumaList(const std::string& list){
+    Vector<int> result;
+    size_t pos = 0;
+    while(pos < list.size()){
+        size_t end = 0;
+        const int first = std::stoi(list.substr(pos), &end);
+        pos += end;
+        int last = first;
+        if(pos < list.size() && list[pos] == '-'){
+            last = std::stoi(list.substr(pos + 1), &end);
+            pos += end + 1;
+        }
+        for(int value = first; value <= last; ++value){
+            result.PushBack(value);
+        }
+        while(pos < list.size() && (list[pos] == ',' || list[pos] == '\n')){
+            ++pos;
+        }
+    }
+    return result;
+}
+
+// Содержимое файла sysfs или пустая строка, если его нет
+inline std::string ReadSysfs(const std::string& path){
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+#if defined(__linux__)
+inline constexpr int MPOL_BIND_MODE = 2;
+inline constexpr int MPOL_INTERLEAVE_MODE = 3;
+
+// Номер узла для каждой из count страниц, NUMA_NO_NODE для неотображённых.
+// move_pages без целевых узлов только сообщает размещение и не касается страниц
+inline void QueryPageNodes(void** pages, int* nodes, size_t count) noexcept {
+    if(syscall(SYS_move_pages, 0, count, pages, nullptr, nodes, 0) != 0){
+        std::fill_n(nodes, count, NUMA_NO_NODE);
+        return;
+    }
+    std::replace_if(nodes, nodes + count, [](int node) {
+        return node < 0;
+    }, NUMA_NO_NODE);
+}
+
+inline size_t PageSize() noexcept {
+    static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return page_size;
+}
+#endif
+
+}  // namespace detail
+
+// Число узлов NUMA; 1, если система их не сообщает
+inline size_t NumaNodeCount(){
+    static const size_t count = [] {
+        const Vector<int> nodes = detail::ParseNumaList(detail::ReadSysfs("/sys/devices/system/node/online"));
+        return nodes.Size() != 0 ? static_cast<size_t>(nodes[nodes.Size() - 1]) + 1 : size_t{1};
+    }();
+    return count;
+}
+
+// Процессоры узла. Если система не сообщает топологию, все процессоры относятся к узлу 0
+inline Vector<int> NumaNodeCpus(int node){
+    Vector<int> cpus = detail::ParseNumaList(
+        detail::ReadSysfs("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+    if(cpus.Size() == 0 && node == 0 && NumaNodeCount() == 1){
+        for(unsigned cpu = 0; cpu < std::max(std::thread::hardware_concurrency(), 1u); ++cpu){
+            cpus.PushBack(static_cast<int>(cpu));
+        }
+    }
+    return cpus;
+}
+
+// Узел процессора, на котором сейчас выполняется поток
+inline int CurrentNumaNode() noexcept {
+#if defined(__linux__)
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if(syscall(SYS_getcpu, &cpu, &node, nullptr) == 0){
+        return static_cast<int>(node);
+    }
+#endif
+    return 0;
+}
+
+// Ограничивает текущий поток процессорами узла. Возвращает false, если это не удалось
+inline bool PinThreadToNumaNode(int node){
+#if defined(__linux__)
+    const Vector<int> cpus = NumaNodeCpus(node);
+    if(cpus.Size() == 0){
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(int cpu : cpus){
+        if(cpu < CPU_SETSIZE){
+            CPU_SET(cpu, &set);
+        }
+    }
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)node;
+    return false;
+#endif
+}
+
+// Узел, в памяти которого лежит страница с address, или NUMA_NO_NODE
+inline int NumaNodeOf(const void* address) noexcept {
+#if defined(__linux__)
+    void* page = const_cast<void*>(address);
+    int node = NUMA_NO_NODE;
+    detail::QueryPageNodes(&page, &node, 1);
+    return node;
+#else
+    (void)address;
+    return NUMA_NO_NODE;
+#endif
+}
+
+// Узлы всех страниц, которые пересекает [data, data + bytes), по порядку
+inline Vector<int> NumaPageNodes(const void* data, size_t bytes){
+    Vector<int> nodes;
+    if(bytes == 0){
+        return nodes;
+    }
+#if defined(__linux__)
+    const size_t page_size = detail::PageSize();
+    const uintptr_t first = reinterpret_cast<uintptr_t>(data) / page_size;
+    const uintptr_t last = (reinterpret_cast<uintptr_t>(data) + bytes - 1) / page_size;
+    Vector<void*> pages(last - first + 1);
+    for(size_t i = 0; i < pages.Size(); ++i){
+        pages[i] = reinterpret_cast<void*>((first + i) * page_size);
+    }
+    nodes.Resize(pages.Size());
+    detail::QueryPageNodes(pages.begin(), nodes.begin(), pages.Size());
+#else
+    nodes.Resize(1);
+    nodes[0] = NUMA_NO_NODE;
+#endif
+    return nodes;
+}
+
+enum class NumaPlacement {
+    // Страница попадает на узел потока, первым записавшего в неё (поведение ядра по умолчанию)
+    FIRST_TOUCH,
+    // Все страницы размещаются на заданном узле
+    BIND,
+    // Страницы распределяются по всем узлам по очереди
+    INTERLEAVE,
+};
+
+struct NumaPolicy {
+    NumaPlacement placement = NumaPlacement::FIRST_TOUCH;
+    // Узел для NumaPlacement::BIND
+    int node = 0;
+
+    bool operator==(const NumaPolicy& other) const noexcept {
+        return placement == other.placement && (placement != NumaPlacement::BIND || node == other.node);
+    }
+
+    bool operator!=(const NumaPolicy& other) const noexcept {
+        return !(*this == other);
+    }
+};
+
+// Аллокатор с политикой размещения страниц по узлам NUMA. Буферы от MMAP_THRESHOLD байт
+// отображаются mmap отдельно и размечаются mbind до первого обращения, поэтому
+// политика действует на каждую их страницу. Меньшие буферы берутся из operator new
+// без особого размещения. На системе с одним узлом и вне Linux политика ничего не меняет.
+// Аллокатор хранит политику, и вектора с разными политиками не обмениваются буферами
+template <typename T>
+class NumaAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    static constexpr size_t MMAP_THRESHOLD = 64 * 1024;
+
+    NumaAllocator() noexcept = default;
+
+    explicit NumaAllocator(NumaPolicy policy) noexcept
+    : policy_(policy){
+    }
+
+    template <typename U>
+    NumaAllocator(const NumaAllocator<U>& other) noexcept
+    : policy_(other.Policy()){
+    }
+
+    NumaPolicy Policy() const noexcept {
+        return policy_;
+    }
+
+    T* allocate(size_t n){
+        if(n > std::numeric_limits<size_t>::max() / sizeof(T)){
+            throw std::bad_array_new_length();
+        }
+        const size_t bytes = n * sizeof(T);
+#if defined(__linux__)
+        if(bytes >= MMAP_THRESHOLD){
+            void* const buffer = mmap(nullptr, RoundToPages(bytes), PROT_READ | PROT_WRITE,
+                                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if(buffer == MAP_FAILED){
+                throw std::bad_alloc();
+            }
+            // Как и madvise в AlignedAllocator, mbind - пожелание: при ошибке остаётся first-touch
+            ApplyPolicy(buffer, RoundToPages(bytes));
+            return static_cast<T*>(buffer);
+        }
+#endif
+        return static_cast<T*>(operator new(bytes, std::align_val_t{alignof(T)}));
+    }
+
+    void deallocate(T* buffer, size_t n) noexcept {
+        const size_t bytes = n * sizeof(T);
+#if defined(__linux__)
+        if(bytes >= MMAP_THRESHOLD){
+            munmap(buffer, RoundToPages(bytes));
+            return;
+        }
+#endif
+        operator delete(buffer, std::align_val_t{alignof(T)});
+    }
+
+    template <typename U>
+    bool operator==(const NumaAllocator<U>& other) const noexcept {
+        return policy_ == other.Policy();
+    }
+
+    template <typename U>
+    bool operator!=(const NumaAllocator<U>& other) const noexcept {
+        return !(*this == other);
+    }
+
+private:
+#if defined(__linux__)
+    static size_t RoundToPages(size_t bytes) noexcept {
+        const size_t page_size = detail::PageSize();
+        return (bytes + page_size - 1) / page_size * page_size;
+    }
+
+    // Маска узлов умещается в одно слово: поддерживаются первые 64 узла
+    void ApplyPolicy(void* buffer, size_t bytes) const noexcept {
+        constexpr size_t MASK_BITS = sizeof(unsigned long) * 8;
+        unsigned long mask = 0;
+        int mode = 0;
+        if(policy_.placement == NumaPlacement::BIND){
+            if(policy_.node < 0 || static_cast<size_t>(policy_.node) >= MASK_BITS){
+                return;
+            }
+            mode = detail::MPOL_BIND_MODE;
+            mask = 1ul << policy_.node;
+        } else if(policy_.placement == NumaPlacement::INTERLEAVE){
+            mode = detail::MPOL_INTERLEAVE_MODE;
+            const size_t nodes = std::min(NumaNodeCount(), MASK_BITS);
+            mask = nodes == MASK_BITS ? ~0ul : (1ul << nodes) - 1;
+        } else {
+            return;
+        }
+        syscall(SYS_mbind, buffer, bytes, mode, &mask, MASK_BITS + 1, 0);
+    }
+#endif
+
+    NumaPolicy policy_;
+};
+
+template <typename T>
+using NumaVector = Vector<T, NumaAllocator<T>>;
+
+// По пулу потоков на каждый узел NUMA. Потоки пула привязаны к процессорам своего узла,
+// поэтому порция, отданная пулу узла, обрабатывается потоком, локальным для её памяти
+class NumaThreadPools {
+public:
+    // Столько потоков на узел, сколько у него процессоров
+    NumaThreadPools()
+    : NumaThreadPools(0){
+    }
+
+    // threads_per_node == 0 - по числу процессоров узла
+    explicit NumaThreadPools(size_t threads_per_node){
+        const size_t node_count = NumaNodeCount();
+        pools_.Reserve(node_count);
+        for(size_t node = 0; node < node_count; ++node){
+            const size_t threads = threads_per_node != 0 ? threads_per_node
+                                                         : NumaNodeCpus(static_cast<int>(node)).Size();
+            pools_.EmplaceBack(std::make_unique<ThreadPool>(threads, [node](size_t) {
+                PinThreadToNumaNode(static_cast<int>(node));
+            }));
+        }
+    }
+
+    static NumaThreadPools& Default(){
+        static NumaThreadPools pools;
+        return pools;
+    }
+
+    size_t NodeCount() const noexcept {
+        return pools_.Size();
+    }
+
+    ThreadPool& Pool(size_t node) noexcept {
+        assert(node < pools_.Size());
+        return *pools_[node];
+    }
+
+    size_t ThreadCount() const noexcept {
+        size_t count = 0;
+        for(const auto& pool : pools_){
+            count += pool->ThreadCount();
+        }
+        return count;
+    }
+
+    // Делит [0, count) на порции по grain элементов и вызывает body(begin, end) для каждой
+    // в пуле узла node_of(chunk). Вызывающий поток сначала обрабатывает порции своего узла,
+    // затем помогает с остальными, так что порции узла без потоков тоже выполняются.
+    // Первое исключение из body прерывает раздачу порций и пробрасывается после завершения начатых
+    template <typename NodeOf, typename Body>
+    void Run(size_t count, size_t grain, NodeOf node_of, Body body){
+        if(count == 0){
+            return;
+        }
+        const size_t chunk_count = (count + grain - 1) / grain;
+
+        struct NodeChunks {
+            Vector<size_t> chunks;
+            std::atomic<size_t> next = 0;
+        };
+        struct SharedState {
+            explicit SharedState(size_t node_count)
+            : nodes(node_count){
+            }
+
+            Vector<NodeChunks> nodes;
+            std::atomic<size_t> running_helpers = 0;
+            std::mutex error_mutex;
+            std::exception_ptr error;
+        } state(NodeCount());
+        for(size_t chunk = 0; chunk < chunk_count; ++chunk){
+            const size_t node = std::min(static_cast<size_t>(node_of(chunk)), NodeCount() - 1);
+            state.nodes[node].chunks.PushBack(chunk);
+        }
+
+        const auto run_node = [&state, &body, count, grain](size_t node) {
+            NodeChunks& own = state.nodes[node];
+            try {
+                for(size_t i; (i = own.next.fetch_add(1)) < own.chunks.Size();){
+                    const size_t begin = own.chunks[i] * grain;
+                    body(begin, std::min(begin + grain, count));
+                }
+            } catch(...){
+                for(NodeChunks& node_chunks : state.nodes){
+                    node_chunks.next = node_chunks.chunks.Size();
+                }
+                std::lock_guard lock(state.error_mutex);
+                if(!state.error){
+                    state.error = std::current_exception();
+                }
+            }
+        };
+
+        for(size_t node = 0; node < NodeCount(); ++node){
+            ThreadPool& pool = *pools_[node];
+            const size_t helpers = std::min(pool.ThreadCount(), state.nodes[node].chunks.Size());
+            for(size_t i = 0; i < helpers; ++i){
+                state.running_helpers.fetch_add(1);
+                try {
+                    pool.Submit([&state, &run_node, node] {
+                        run_node(node);
+                        state.running_helpers.fetch_sub(1, std::memory_order_release);
+                    });
+                } catch(...){
+                    // Порции узла выполнит вызывающий поток
+                    state.running_helpers.fetch_sub(1);
+                    break;
+                }
+            }
+        }
+
+        const size_t home = std::min(static_cast<size_t>(CurrentNumaNode()), NodeCount() - 1);
+        for(size_t offset = 0; offset < NodeCount(); ++offset){
+            run_node((home + offset) % NodeCount());
+        }
+        // Как и в ParallelFor, ожидающий поток выполняет чужие задачи: если Run вызван
+        // из рабочего потока, помощники могли попасть в его собственную очередь
+        while(state.running_helpers.load(std::memory_order_acquire) != 0){
+            if(!RunPendingTask(home)){
+                std::this_thread::yield();
+            }
+        }
+        if(state.error){
+            std::rethrow_exception(state.error);
+        }
+    }
+
+private:
+    // Выполняет задачу из пула узла home или, если там пусто, из остальных
+    bool RunPendingTask(size_t home){
+        for(size_t offset = 0; offset < NodeCount(); ++offset){
+            if(pools_[(home + offset) % NodeCount()]->RunPendingTask()){
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Vector<std::unique_ptr<ThreadPool>> pools_;
+};
+
+struct NumaParallelOptions {
+    // nullptr - NumaThreadPools::Default()
+    NumaThreadPools* pools = nullptr;
+    // Число элементов в одной порции работы, 0 - подобрать по числу потоков
+    size_t grain_size = 0;
+};
+
+namespace detail {
+
+inline NumaThreadPools& GetPools(const NumaParallelOptions& options){
+    return options.pools != nullptr ? *options.pools : NumaThreadPools::Default();
+}
+
+inline size_t GetGrainSize(const NumaParallelOptions& options, size_t count){
+    if(options.grain_size != 0){
+        return options.grain_size;
+    }
+    const size_t chunks = (GetPools(options).ThreadCount() + 1) * 4;
+    return std::max<size_t>((count + chunks - 1) / chunks, 1);
+}
+
+// Порции делятся между узлами непрерывными блоками по порядку
+inline size_t BlockedNode(size_t chunk, size_t chunk_count, size_t node_count) noexcept {
+    return chunk * node_count / chunk_count;
+}
+
+}  // namespace detail
+
+// Политика выполнения, закрепляющая порции за узлами непрерывными блоками: первая
+// доля порций выполняется потоками узла 0, следующая - узла 1 и так далее.
+// Vector<T, NumaAllocator<T>> v(n, NumaParallelPolicy{}) или v.Resize(n, numa_par) с
+// NumaPlacement::FIRST_TOUCH размещает страницы каждого блока на его узле, и последующие
+// вызовы For с тем же числом элементов и порций читают память локально
+struct NumaParallelPolicy {
+    NumaParallelOptions options;
+
+    template <typename Body>
+    void For(size_t count, Body body) const {
+        NumaThreadPools& pools = detail::GetPools(options);
+        const size_t grain = detail::GetGrainSize(options, count);
+        const size_t chunk_count = (count + grain - 1) / grain;
+        pools.Run(count, grain, [chunk_count, &pools](size_t chunk) {
+            return detail::BlockedNode(chunk, chunk_count, pools.NodeCount());
+        }, std::move(body));
+    }
+
+    template <typename Construct, typename Destroy>
+    void UninitializedFor(size_t count, Construct construct, Destroy destroy) const {
+        if(count == 0){
+            return;
+        }
+        NumaParallelPolicy chunk_policy = *this;
+        chunk_policy.options.grain_size = detail::GetGrainSize(options, count);
+        detail::UninitializedChunks(count, chunk_policy.options.grain_size, [&](auto body) {
+            chunk_policy.For(count, std::move(body));
+        }, construct, destroy);
+    }
+};
+
+inline constexpr NumaParallelPolicy numa_par{};
+
+template <>
+struct is_execution_policy<NumaParallelPolicy> : std::true_type {};
+
+// Вызывает body(begin, end) для порций [0, count) массива data в потоках узла,
+// на котором лежит первый элемент порции. Подходит для памяти с любым размещением,
+// в том числе INTERLEAVE и BIND; порции неотображённых страниц делятся между узлами блоками
+template <typename T, typename Body>
+void NumaParallelFor(T* data, size_t count, Body body, const NumaParallelOptions& options = {}){
+    if(count == 0){
+        return;
+    }
+    NumaThreadPools& pools = detail::GetPools(options);
+    const size_t grain = detail::GetGrainSize(options, count);
+    const size_t chunk_count = (count + grain - 1) / grain;
+    Vector<int> nodes(chunk_count);
+#if defined(__linux__)
+    Vector<void*> chunk_starts(chunk_count);
+    for(size_t chunk = 0; chunk < chunk_count; ++chunk){
+        chunk_starts[chunk] = const_cast<std::remove_cv_t<T>*>(data + chunk * grain);
+    }
+    detail::QueryPageNodes(chunk_starts.begin(), nodes.begin(), chunk_count);
+#else
+    std::fill(nodes.begin(), nodes.end(), NUMA_NO_NODE);
+#endif
+    pools.Run(count, grain, [&nodes, chunk_count, &pools](size_t chunk) {
+        return nodes[chunk] != NUMA_NO_NODE ? static_cast<size_t>(nodes[chunk])
+                                            : detail::BlockedNode(chunk, chunk_count, pools.NodeCount());
+    }, std::move(body));
+}
+
+template <typename T, typename... Params, typename Function>
+void NumaParallelForEach(Vector<T, Params...>& vector, Function function, const NumaParallelOptions& options = {}){
+    T* const data = vector.begin();
+    NumaParallelFor(data, vector.Size(), [data, &function](size_t begin, size_t end) {
+        std::for_each(data + begin, data + end, function);
+    }, options);
+}
+
+template <typename T, typename... Params, typename Function>
+void NumaParallelForEach(const Vector<T, Params...>& vector, Function function,
+                         const NumaParallelOptions& options = {}){
+    const T* const data = vector.begin();
+    NumaParallelFor(data, vector.Size(), [data, &function](size_t begin, size_t end) {
+        std::for_each(data + begin, data + end, function);
+    }, options);
+}
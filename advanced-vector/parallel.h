@@ -0,0 +1,406 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <utility>
+
+// Пул потоков с очередью задач у каждого потока. Поток берёт задачи с конца
+// своей очереди, а опустев, крадёт их из начала чужих очередей
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(size_t thread_count)
+    : ThreadPool(thread_count, nullptr){
+    }
+
+    // on_start(index) выполняется в каждом рабочем потоке до первой задачи,
+    // например чтобы привязать поток к процессорам
+    ThreadPool(size_t thread_count, std::function<void(size_t)> on_start){
+        queues_.Reserve(thread_count);
+        for(size_t i = 0; i < thread_count; ++i){
+            queues_.EmplaceBack(std::make_unique<WorkerQueue>());
+        }
+        threads_.Reserve(thread_count);
+        try {
+            for(size_t i = 0; i < thread_count; ++i){
+                threads_.EmplaceBack([this, i, on_start] {
+                    if(on_start){
+                        on_start(i);
+                    }
+                    WorkerLoop(i);
+                });
+            }
+        } catch(...){
+            Stop();
+            throw;
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool(){
+        Stop();
+    }
+
+    // Общий пул. Вызывающий поток участвует в параллельных алгоритмах сам,
+    // поэтому рабочих потоков на один меньше, чем аппаратных
+    static ThreadPool& Default(){
+        static ThreadPool pool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+        return pool;
+    }
+
+    size_t ThreadCount() const noexcept {
+        return threads_.Size();
+    }
+
+    // Задача, поставленная из рабочего потока, попадает в его собственную очередь
+    void Submit(Task task){
+        assert(ThreadCount() != 0);
+        const size_t index = current_pool_ == this
+            ? current_index_
+            : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.Size();
+        {
+            std::lock_guard lock(sleep_mutex_);
+            ++pending_;
+        }
+        // Счётчик увеличивается до постановки, чтобы взявший задачу поток не опустил его ниже нуля,
+        // и возвращается назад, если push_back бросил исключение
+        try {
+            std::lock_guard lock(queues_[index]->mutex);
+            queues_[index]->tasks.push_back(std::move(task));
+        } catch(...){
+            std::lock_guard lock(sleep_mutex_);
+            --pending_;
+            throw;
+        }
+        wake_.notify_one();
+    }
+
+    // Выполняет одну из ожидающих задач. Позволяет ожидающему потоку помогать пулу
+    bool RunPendingTask(){
+        Task task;
+        const size_t start = current_pool_ == this ? current_index_ : 0;
+        if(!TakeTask(start, task)){
+            return false;
+        }
+        task();
+        return true;
+    }
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // Дожидается выполнения оставшихся задач и завершает потоки
+    void Stop() noexcept {
+        {
+            std::lock_guard lock(sleep_mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for(std::thread& thread : threads_){
+            thread.join();
+        }
+    }
+
+    bool TakeTask(size_t own_index, Task& task){
+        if(queues_.Size() == 0){
+            return false;
+        }
+        {
+            WorkerQueue& own = *queues_[own_index];
+            std::lock_guard lock(own.mutex);
+            if(!own.tasks.empty()){
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                --pending_;
+                return true;
+            }
+        }
+        for(size_t offset = 1; offset < queues_.Size(); ++offset){
+            WorkerQueue& victim = *queues_[(own_index + offset) % queues_.Size()];
+            std::lock_guard lock(victim.mutex);
+            if(!victim.tasks.empty()){
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                --pending_;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void WorkerLoop(size_t index){
+        current_pool_ = this;
+        current_index_ = index;
+        for(;;){
+            Task task;
+            if(TakeTask(index, task)){
+                task();
+                continue;
+            }
+            std::unique_lock lock(sleep_mutex_);
+            wake_.wait(lock, [this] {
+                return stop_ || pending_ != 0;
+            });
+            if(stop_ && pending_ == 0){
+                return;
+            }
+        }
+    }
+
+    Vector<std::unique_ptr<WorkerQueue>> queues_;
+    Vector<std::thread> threads_;
+    std::atomic<size_t> next_queue_ = 0;
+    std::atomic<size_t> pending_ = 0;
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    bool stop_ = false;
+
+    inline static thread_local ThreadPool* current_pool_ = nullptr;
+    inline static thread_local size_t current_index_ = 0;
+};
+
+struct ParallelOptions {
+    // nullptr - ThreadPool::Default()
+    ThreadPool* pool = nullptr;
+    // Число элементов в одной порции работы, 0 - подобрать по числу потоков
+    size_t grain_size = 0;
+};
+
+namespace detail {
+
+inline ThreadPool& GetPool(const ParallelOptions& options){
+    return options.pool != nullptr ? *options.pool : ThreadPool::Default();
+}
+
+inline size_t GetGrainSize(const ParallelOptions& options, size_t count, size_t chunks_per_thread){
+    if(options.grain_size != 0){
+        return options.grain_size;
+    }
+    const size_t chunks = (GetPool(options).ThreadCount() + 1) * chunks_per_thread;
+    return std::max<size_t>((count + chunks - 1) / chunks, 1);
+}
+
+}  // namespace detail
+
+// Делит [0, count) на непрерывные порции по grain_size элементов и вызывает
+// body(begin, end) для каждой. Потоки разбирают порции по порядку, так что соседние
+// порции обрабатываются близко по времени. Первое исключение из body прерывает
+// раздачу оставшихся порций и пробрасывается после завершения уже начатых
+template <typename Body>
+void ParallelFor(size_t count, Body body, const ParallelOptions& options = {}){
+    if(count == 0){
+        return;
+    }
+    ThreadPool& pool = detail::GetPool(options);
+    const size_t grain = detail::GetGrainSize(options, count, 4);
+    const size_t chunk_count = (count + grain - 1) / grain;
+    const size_t helpers = std::min(pool.ThreadCount(), chunk_count - 1);
+    if(helpers == 0){
+        body(size_t{0}, count);
+        return;
+    }
+
+    struct SharedState {
+        std::atomic<size_t> next_chunk = 0;
+        std::atomic<size_t> running_helpers;
+        std::mutex error_mutex;
+        std::exception_ptr error;
+    } state;
+    state.running_helpers = helpers;
+
+    const auto run_chunks = [&state, &body, count, grain, chunk_count] {
+        try {
+            for(size_t chunk; (chunk = state.next_chunk.fetch_add(1)) < chunk_count;){
+                const size_t begin = chunk * grain;
+                body(begin, std::min(begin + grain, count));
+            }
+        } catch(...){
+            state.next_chunk = chunk_count;
+            std::lock_guard lock(state.error_mutex);
+            if(!state.error){
+                state.error = std::current_exception();
+            }
+        }
+    };
+
+    for(size_t i = 0; i < helpers; ++i){
+        try {
+            pool.Submit([&state, &run_chunks] {
+                run_chunks();
+                state.running_helpers.fetch_sub(1, std::memory_order_release);
+            });
+        } catch(...){
+            // Порции, доставшиеся бы непоставленным помощникам, выполнят остальные
+            state.running_helpers.fetch_sub(helpers - i);
+            break;
+        }
+    }
+    run_chunks();
+    while(state.running_helpers.load(std::memory_order_acquire) != 0){
+        if(!pool.RunPendingTask()){
+            std::this_thread::yield();
+        }
+    }
+    if(state.error){
+        std::rethrow_exception(state.error);
+    }
+}
+
+namespace detail {
+
+// Строит [0, count) порциями по grain элементов: for_chunks(body) вызывает body(begin, end)
+// для каждой порции. Если построение бросает исключение, порции, построенные
+// полностью, уничтожаются вызовами destroy(begin, end)
+template <typename ForChunks, typename Construct, typename Destroy>
+void UninitializedChunks(size_t count, size_t grain, ForChunks for_chunks, Construct& construct, Destroy& destroy){
+    const size_t chunk_count = (count + grain - 1) / grain;
+    Vector<unsigned char> constructed(chunk_count);
+    try {
+        for_chunks([&](size_t begin, size_t end) {
+            construct(begin, end);
+            for(size_t chunk = begin / grain; chunk * grain < end; ++chunk){
+                constructed[chunk] = 1;
+            }
+        });
+    } catch(...){
+        for(size_t chunk = 0; chunk < chunk_count; ++chunk){
+            if(constructed[chunk]){
+                destroy(chunk * grain, std::min((chunk + 1) * grain, count));
+            }
+        }
+        throw;
+    }
+}
+
+}  // namespace detail
+
+// Политика выполнения для перегрузок Vector, строящих и уничтожающих элементы
+// параллельно: Vector copy(other, par) или v.Reserve(n, ParallelPolicy{{&pool, 4096}}).
+// Потоки, построившие элементы, первыми касаются их страниц памяти
+struct ParallelPolicy {
+    ParallelOptions options;
+
+    template <typename Body>
+    void For(size_t count, Body body) const {
+        ParallelFor(count, std::move(body), options);
+    }
+
+    // Строит порции вызовами construct(begin, end). Если одна из них бросает
+    // исключение, порции, построенные полностью, уничтожаются вызовами destroy(begin, end)
+    template <typename Construct, typename Destroy>
+    void UninitializedFor(size_t count, Construct construct, Destroy destroy) const {
+        if(count == 0){
+            return;
+        }
+        ParallelOptions chunk_options = options;
+        chunk_options.grain_size = detail::GetGrainSize(options, count, 4);
+        detail::UninitializedChunks(count, chunk_options.grain_size, [&](auto body) {
+            ParallelFor(count, std::move(body), chunk_options);
+        }, construct, destroy);
+    }
+};
+
+inline constexpr ParallelPolicy par{};
+
+template <>
+struct is_execution_policy<ParallelPolicy> : std::true_type {};
+
+template <typename T, typename... Params, typename Function>
+void ParallelForEach(Vector<T, Params...>& vector, Function function, const ParallelOptions& options = {}){
+    T* const data = vector.begin();
+    ParallelFor(vector.Size(), [data, &function](size_t begin, size_t end) {
+        std::for_each(data + begin, data + end, function);
+    }, options);
+}
+
+template <typename T, typename... Params, typename Function>
+void ParallelForEach(const Vector<T, Params...>& vector, Function function, const ParallelOptions& options = {}){
+    const T* const data = vector.begin();
+    ParallelFor(vector.Size(), [data, &function](size_t begin, size_t end) {
+        std::for_each(data + begin, data + end, function);
+    }, options);
+}
+
+// Записывает operation(input[i]) в output[i], предварительно установив размер output
+template <typename T, typename... InParams, typename U, typename... OutParams, typename Operation>
+void ParallelTransform(const Vector<T, InParams...>& input, Vector<U, OutParams...>& output,
+                       Operation operation, const ParallelOptions& options = {}){
+    output.Resize(input.Size());
+    const T* const in = input.begin();
+    U* const out = output.begin();
+    ParallelFor(input.Size(), [in, out, &operation](size_t begin, size_t end) {
+        std::transform(in + begin, in + end, out + begin, operation);
+    }, options);
+}
+
+// Свёртка с ассоциативной операцией. Порции сворачиваются независимо,
+// а их результаты объединяются с init в исходном порядке
+template <typename T, typename... Params, typename Result, typename Operation = std::plus<>>
+Result ParallelReduce(const Vector<T, Params...>& vector, Result init, Operation operation = {},
+                      const ParallelOptions& options = {}){
+    const size_t size = vector.Size();
+    if(size == 0){
+        return init;
+    }
+    const size_t grain = detail::GetGrainSize(options, size, 4);
+    const size_t chunk_count = (size + grain - 1) / grain;
+    Vector<Result> partial(chunk_count);
+    const T* const data = vector.begin();
+    ParallelOptions chunk_options = options;
+    chunk_options.grain_size = 1;
+    ParallelFor(chunk_count, [&](size_t first_chunk, size_t last_chunk) {
+        for(size_t chunk = first_chunk; chunk < last_chunk; ++chunk){
+            const T* const begin = data + chunk * grain;
+            const T* const end = data + std::min((chunk + 1) * grain, size);
+            partial[chunk] = std::accumulate(begin + 1, end, Result(*begin), operation);
+        }
+    }, chunk_options);
+    return std::accumulate(std::make_move_iterator(partial.begin()), std::make_move_iterator(partial.end()),
+                           std::move(init), operation);
+}
+
+// Сортирует порции параллельно, затем сливает соседние пары порций,
+// удваивая их длину на каждом проходе
+template <typename T, typename... Params, typename Compare = std::less<>>
+void ParallelSort(Vector<T, Params...>& vector, Compare compare = {}, const ParallelOptions& options = {}){
+    const size_t size = vector.Size();
+    const size_t grain = detail::GetGrainSize(options, size, 1);
+    T* const data = vector.begin();
+    ParallelOptions chunk_options = options;
+    chunk_options.grain_size = 1;
+
+    const size_t chunk_count = (size + grain - 1) / grain;
+    ParallelFor(chunk_count, [&](size_t first_chunk, size_t last_chunk) {
+        for(size_t chunk = first_chunk; chunk < last_chunk; ++chunk){
+            std::sort(data + chunk * grain, data + std::min((chunk + 1) * grain, size), compare);
+        }
+    }, chunk_options);
+
+    for(size_t width = grain; width < size; width *= 2){
+        const size_t pair_count = (size + 2 * width - 1) / (2 * width);
+        ParallelFor(pair_count, [&](size_t first_pair, size_t last_pair) {
+            for(size_t pair = first_pair; pair < last_pair; ++pair){
+                const size_t begin = pair * 2 * width;
+                const size_t middle = std::min(begin + width, size);
+                const size_t end = std::min(begin + 2 * width, size);
+                std::inplace_merge(data + begin, data + middle, data + end, compare);
+            }
+        }, chunk_options);
+    }
+}
@@ -0,0 +1,288 @@
+#pragma once
+#include "vector.h"
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+// Счётчики пула текущего потока
+struct PoolStats {
+    size_t hits = 0;           // выделения из списка свободных блоков
+    size_t misses = 0;         // выделения через operator new
+    size_t remote_frees = 0;   // блоки, полученные обратно из других потоков
+    size_t releases = 0;       // блоки, отданные operator delete сверх лимита кэша
+
+    double HitRate() const noexcept {
+        return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses);
+    }
+};
+
+namespace detail {
+
+// Наименьшее k, при котором (unit << k) >= bytes
+constexpr size_t Log2Ceil(size_t bytes, size_t unit) noexcept {
+    size_t result = 0;
+    while((unit << result) < bytes){
+        ++result;
+    }
+    return result;
+}
+
+}  // namespace detail
+
+// Пул буферов с классами размеров - степенями двойки от MIN_BLOCK_SIZE до MAX_BLOCK_SIZE байт.
+// У каждого потока свои списки свободных блоков, поэтому выделение и освобождение в потоке-владельце
+// обходятся без синхронизации. Блок, освобождённый чужим потоком, кладётся CAS в стек
+// возврата владельца, который тот забирает целиком при очередном промахе.
+// Перед блоком хранится заголовок с владельцем и классом размера. Пулы завершившихся
+// потоков не удаляются, а передаются новым потокам, поэтому возврат блока всегда
+// находит живого владельца. Запросы больше MAX_BLOCK_SIZE идут напрямую в operator new
+class SizeClassPool {
+public:
+    static constexpr size_t MIN_BLOCK_SIZE = 16;
+    static constexpr size_t MAX_BLOCK_SIZE = 64 * 1024;
+    // Лимит памяти в кэше одного класса размеров одного потока
+    static constexpr size_t MAX_CACHED_BYTES = 256 * 1024;
+
+    static void* Allocate(size_t bytes){
+        if(bytes > MAX_BLOCK_SIZE){
+            return ::operator new(bytes);
+        }
+        const size_t size_class = SizeClassOf(bytes);
+        Shard* const shard = LocalShard();
+        if(shard == nullptr){
+            return NewBlock(nullptr, size_class);
+        }
+        return shard->Allocate(size_class);
+    }
+
+    // bytes должен совпадать с размером, переданным в Allocate
+    static void Deallocate(void* buffer, size_t bytes) noexcept {
+        if(bytes > MAX_BLOCK_SIZE){
+            ::operator delete(buffer);
+            return;
+        }
+        Header* const header = HeaderOf(buffer);
+        Shard* const shard = CurrentShard();
+        if(header->owner == nullptr){
+            ::operator delete(header);
+        } else if(header->owner == shard){
+            shard->Free(header);
+        } else {
+            header->owner->PushRemote(header);
+        }
+    }
+
+    static PoolStats GetThreadStats() noexcept {
+        Shard* const shard = CurrentShard();
+        return shard != nullptr ? shard->stats : PoolStats{};
+    }
+
+    static void ResetThreadStats() noexcept {
+        if(Shard* const shard = CurrentShard()){
+            shard->stats = PoolStats{};
+        }
+    }
+
+    // Возвращает operator delete все свободные блоки текущего потока
+    static void TrimThreadCache() noexcept {
+        if(Shard* const shard = CurrentShard()){
+            shard->DrainRemote();
+            shard->Trim();
+        }
+    }
+
+    static constexpr size_t SizeClassOf(size_t bytes) noexcept {
+        return detail::Log2Ceil(bytes, MIN_BLOCK_SIZE);
+    }
+
+private:
+    static constexpr size_t CLASS_COUNT = detail::Log2Ceil(MAX_BLOCK_SIZE, MIN_BLOCK_SIZE) + 1;
+
+    struct Shard;
+
+    // Заголовок занимает alignof(std::max_align_t) байт и сохраняет выравнивание блока
+    struct alignas(std::max_align_t) Header {
+        Shard* owner;
+        size_t size_class;
+        Header* next;
+    };
+
+    struct Shard {
+        void* Allocate(size_t size_class){
+            if(free[size_class] == nullptr){
+                DrainRemote();
+            }
+            if(Header* const header = free[size_class]){
+                free[size_class] = header->next;
+                --cached[size_class];
+                ++stats.hits;
+                return header + 1;
+            }
+            ++stats.misses;
+            return NewBlock(this, size_class);
+        }
+
+        void Free(Header* header) noexcept {
+            const size_t size_class = header->size_class;
+            if(cached[size_class] >= MaxCached(size_class)){
+                ++stats.releases;
+                ::operator delete(header);
+                return;
+            }
+            header->next = free[size_class];
+            free[size_class] = header;
+            ++cached[size_class];
+        }
+
+        // Вызывается из чужих потоков
+        void PushRemote(Header* header) noexcept {
+            header->next = remote.load(std::memory_order_relaxed);
+            while(!remote.compare_exchange_weak(header->next, header, std::memory_order_release,
+                                                std::memory_order_relaxed)){
+            }
+        }
+
+        // Забирает весь стек возврата одной операцией, поэтому проблемы ABA не возникает
+        void DrainRemote() noexcept {
+            Header* header = remote.exchange(nullptr, std::memory_order_acquire);
+            while(header != nullptr){
+                Header* const next = header->next;
+                ++stats.remote_frees;
+                Free(header);
+                header = next;
+            }
+        }
+
+        void Trim() noexcept {
+            for(size_t size_class = 0; size_class < CLASS_COUNT; ++size_class){
+                while(Header* const header = free[size_class]){
+                    free[size_class] = header->next;
+                    ::operator delete(header);
+                }
+                cached[size_class] = 0;
+            }
+        }
+
+        static constexpr size_t MaxCached(size_t size_class) noexcept {
+            return MAX_CACHED_BYTES / (MIN_BLOCK_SIZE << size_class);
+        }
+
+        Header* free[CLASS_COUNT] = {};
+        size_t cached[CLASS_COUNT] = {};
+        PoolStats stats;
+        Shard* next_abandoned = nullptr;
+        std::atomic<Header*> remote = nullptr;
+    };
+
+    // Пулы завершившихся потоков, ожидающие нового владельца
+    struct Abandoned {
+        std::mutex mutex;
+        Shard* head = nullptr;
+    };
+
+    // Привязывает пул к потоку и передаёт его в Abandoned при завершении потока
+    struct ThreadHandle {
+        ThreadHandle(){
+            Abandoned& abandoned = GetAbandoned();
+            {
+                std::lock_guard lock(abandoned.mutex);
+                shard = abandoned.head;
+                if(shard != nullptr){
+                    abandoned.head = shard->next_abandoned;
+                }
+            }
+            if(shard == nullptr){
+                shard = new Shard;
+            }
+            shard->stats = PoolStats{};
+            CurrentShard() = shard;
+        }
+
+        ~ThreadHandle(){
+            Released() = true;
+            CurrentShard() = nullptr;
+            shard->Trim();
+            Abandoned& abandoned = GetAbandoned();
+            std::lock_guard lock(abandoned.mutex);
+            shard->next_abandoned = abandoned.head;
+            abandoned.head = shard;
+        }
+
+        Shard* shard;
+    };
+
+    static Abandoned& GetAbandoned() noexcept {
+        // Никогда не разрушается: пулы могут понадобиться деструкторам других статических объектов
+        static Abandoned* abandoned = new Abandoned;
+        return *abandoned;
+    }
+
+    // Пул текущего потока или nullptr, если поток ещё ничего не выделял либо уже завершается.
+    // Указатель тривиального типа доступен и после разрушения ThreadHandle
+    static Shard*& CurrentShard() noexcept {
+        static thread_local Shard* current = nullptr;
+        return current;
+    }
+
+    static bool& Released() noexcept {
+        static thread_local bool released = false;
+        return released;
+    }
+
+    // Создаёт пул потока при первом выделении
+    static Shard* LocalShard(){
+        if(CurrentShard() == nullptr && !Released()){
+            static thread_local ThreadHandle handle;
+        }
+        return CurrentShard();
+    }
+
+    static Header* HeaderOf(void* buffer) noexcept {
+        return static_cast<Header*>(buffer) - 1;
+    }
+
+    static void* NewBlock(Shard* owner, size_t size_class){
+        void* const memory = ::operator new(sizeof(Header) + (MIN_BLOCK_SIZE << size_class));
+        Header* const header = new (memory) Header{owner, size_class, nullptr};
+        return header + 1;
+    }
+};
+
+// Аллокатор поверх SizeClassPool для RawMemory и Vector:
+// Vector<T, PoolAllocator<T>> переиспользует буферы, освобождённые при росте и разрушении векторов
+template <typename T>
+class PoolAllocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "PoolAllocator does not support over-aligned types");
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    PoolAllocator() noexcept = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n){
+        return static_cast<T*>(SizeClassPool::Allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* buffer, size_t n) noexcept {
+        SizeClassPool::Deallocate(buffer, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>&) const noexcept {
+        return false;
+    }
+};
+
+template <typename T>
+using PoolVector = Vector<T, PoolAllocator<T>>;
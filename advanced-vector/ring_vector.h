@@ -0,0 +1,283 @@
+#pragma once
+#include "index_iterator.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <utility>
+
+// Кольцевой буфер с добавлением и удалением с обоих концов за O(1), например,
+// для очередей FIFO, где Vector::Erase(begin()) сдвигал бы все элементы.
+// Вместимость - степень двойки, поэтому позиция элемента вычисляется маской.
+// При росте элементы разворачиваются в начало нового буфера не более чем
+// двумя переносами: от head_ до конца старого буфера и от его начала до хвоста
+template <typename T>
+class RingVector {
+public:
+    using value_type = T;
+    using iterator = IndexIterator<RingVector, false>;
+    using const_iterator = IndexIterator<RingVector, true>;
+
+    RingVector() noexcept = default;
+
+    explicit RingVector(size_t size)
+    : RingVector(){
+        Reserve(size);
+        while(size_ < size){
+            EmplaceBack();
+        }
+    }
+
+    RingVector(std::initializer_list<T> list)
+    : RingVector(){
+        Reserve(list.size());
+        for(const T& value : list){
+            EmplaceBack(value);
+        }
+    }
+
+    RingVector(const RingVector& other)
+    : RingVector(){
+        Reserve(other.size_);
+        for(const T& value : other){
+            EmplaceBack(value);
+        }
+    }
+
+    RingVector(RingVector&& other) noexcept {
+        Swap(other);
+    }
+
+    RingVector& operator=(const RingVector& rhs){
+        if(this != &rhs){
+            RingVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    RingVector& operator=(RingVector&& rhs) noexcept {
+        if(this != &rhs){
+            Clear();
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    ~RingVector(){
+        Clear();
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    size_t Capacity() const noexcept {
+        return data_.Capacity();
+    }
+
+    // Вместимость округляется вверх до степени двойки
+    void Reserve(size_t capacity){
+        if(capacity <= Capacity()){
+            return;
+        }
+        RawMemory<T> new_data(RoundUpToPowerOfTwo(capacity));
+        Unwrap(new_data);
+        data_.Swap(new_data);
+        head_ = 0;
+    }
+
+    void PushBack(const T& value){
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value){
+        EmplaceBack(std::move(value));
+    }
+
+    void PushFront(const T& value){
+        EmplaceFront(value);
+    }
+
+    void PushFront(T&& value){
+        EmplaceFront(std::move(value));
+    }
+
+    // При росте новый элемент строится до переноса старых, поэтому аргументы
+    // могут ссылаться на элементы этого же буфера
+    template <typename... Args>
+    T& EmplaceBack(Args&&... ctor_args){
+        if(size_ == Capacity()){
+            RawMemory<T> new_data(NextCapacity());
+            T* const elem = new (new_data + size_) T(std::forward<Args>(ctor_args)...);
+            Grow(new_data, elem);
+            head_ = 0;
+            ++size_;
+            return *elem;
+        }
+        T* const elem = new (Slot(size_)) T(std::forward<Args>(ctor_args)...);
+        ++size_;
+        return *elem;
+    }
+
+    // Новый элемент становится последним в новом буфере, старые элементы - первыми
+    template <typename... Args>
+    T& EmplaceFront(Args&&... ctor_args){
+        if(size_ == Capacity()){
+            RawMemory<T> new_data(NextCapacity());
+            const size_t new_head = new_data.Capacity() - 1;
+            T* const elem = new (new_data + new_head) T(std::forward<Args>(ctor_args)...);
+            Grow(new_data, elem);
+            head_ = new_head;
+            ++size_;
+            return *elem;
+        }
+        const size_t new_head = (head_ - 1) & Mask();
+        T* const elem = new (data_ + new_head) T(std::forward<Args>(ctor_args)...);
+        head_ = new_head;
+        ++size_;
+        return *elem;
+    }
+
+    void PopBack() noexcept {
+        assert(size_ != 0);
+        --size_;
+        std::destroy_at(Slot(size_));
+    }
+
+    void PopFront() noexcept {
+        assert(size_ != 0);
+        std::destroy_at(data_ + head_);
+        head_ = (head_ + 1) & Mask();
+        --size_;
+    }
+
+    // Удаляет все элементы, сохраняя буфер
+    void Clear() noexcept {
+        const size_t first_part = FirstPartSize();
+        std::destroy_n(data_ + head_, first_part);
+        std::destroy_n(data_.GetAddress(), size_ - first_part);
+        head_ = 0;
+        size_ = 0;
+    }
+
+    T& Front() noexcept {
+        assert(size_ != 0);
+        return data_[head_];
+    }
+
+    const T& Front() const noexcept {
+        return const_cast<RingVector&>(*this).Front();
+    }
+
+    T& Back() noexcept {
+        assert(size_ != 0);
+        return *Slot(size_ - 1);
+    }
+
+    const T& Back() const noexcept {
+        return const_cast<RingVector&>(*this).Back();
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<RingVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return *Slot(index);
+    }
+
+    iterator begin() noexcept {
+        return {this, 0};
+    }
+
+    iterator end() noexcept {
+        return {this, size_};
+    }
+
+    const_iterator begin() const noexcept {
+        return {this, 0};
+    }
+
+    const_iterator end() const noexcept {
+        return {this, size_};
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    void Swap(RingVector& other) noexcept {
+        data_.Swap(other.data_);
+        std::swap(head_, other.head_);
+        std::swap(size_, other.size_);
+    }
+
+private:
+    static size_t RoundUpToPowerOfTwo(size_t capacity) noexcept {
+        size_t result = 1;
+        while(result < capacity){
+            result *= 2;
+        }
+        return result;
+    }
+
+    size_t NextCapacity() const noexcept {
+        return Capacity() == 0 ? 1 : Capacity() * 2;
+    }
+
+    size_t Mask() const noexcept {
+        return Capacity() - 1;
+    }
+
+    T* Slot(size_t index) noexcept {
+        return data_ + ((head_ + index) & Mask());
+    }
+
+    // Число элементов от head_ до конца буфера
+    size_t FirstPartSize() const noexcept {
+        return std::min(size_, Capacity() - head_);
+    }
+
+    // Переносит элементы в начало new_data, сохраняя их порядок, и уничтожает старые.
+    // При исключении старые элементы остаются на месте, а new_data - пустым
+    void Unwrap(RawMemory<T>& new_data){
+        const size_t first_part = FirstPartSize();
+        UninitializedRelocateN(data_ + head_, first_part, new_data.GetAddress());
+        try {
+            UninitializedRelocateN(data_.GetAddress(), size_ - first_part, new_data + first_part);
+        } catch(...){
+            std::destroy_n(new_data.GetAddress(), first_part);
+            throw;
+        }
+        DestroyRelocatedN(data_ + head_, first_part);
+        DestroyRelocatedN(data_.GetAddress(), size_ - first_part);
+    }
+
+    // Завершает рост: elem уже построен в new_data и уничтожается, если перенос не удался
+    void Grow(RawMemory<T>& new_data, T* elem){
+        try {
+            Unwrap(new_data);
+        } catch(...){
+            std::destroy_at(elem);
+            throw;
+        }
+        data_.Swap(new_data);
+    }
+
+    RawMemory<T> data_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
@@ -0,0 +1,211 @@
+#pragma once
+#include "index_iterator.h"
+#include "vector.h"
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Разбиение индексов на сегменты геометрически растущего размера:
+// сегмент k содержит FIRST_SIZE * 2^k элементов и начинается с индекса
+// FIRST_SIZE * (2^k - 1). Номер сегмента элемента - старший бит
+// (index / FIRST_SIZE + 1), поэтому поиск элемента не требует циклов
+template <size_t FirstShift>
+struct GeometricSegments {
+    static constexpr size_t FIRST_SIZE = size_t{1} << FirstShift;
+    static constexpr size_t MAX_COUNT = sizeof(size_t) * 8 - FirstShift;
+
+    static constexpr size_t Start(size_t segment) noexcept {
+        return FIRST_SIZE * ((size_t{1} << segment) - 1);
+    }
+
+    static constexpr size_t Size(size_t segment) noexcept {
+        return FIRST_SIZE << segment;
+    }
+
+    static size_t Of(size_t index) noexcept {
+        return sizeof(unsigned long long) * 8 - 1 - __builtin_clzll((index >> FirstShift) + 1);
+    }
+};
+
+// Вектор, хранящий элементы в сегментах GeometricSegments. При росте выделяется
+// новый сегмент, а существующие элементы остаются на месте: добавление занимает
+// O(1) в худшем случае, ссылки и указатели на элементы не инвалидируются
+template <typename T, size_t FirstSegmentShift = 4>
+class SegmentedVector {
+    using Segments = GeometricSegments<FirstSegmentShift>;
+
+public:
+    using value_type = T;
+    using iterator = IndexIterator<SegmentedVector, false>;
+    using const_iterator = IndexIterator<SegmentedVector, true>;
+
+    SegmentedVector() noexcept = default;
+
+    explicit SegmentedVector(size_t size)
+    : SegmentedVector(){
+        Resize(size);
+    }
+
+    SegmentedVector(std::initializer_list<T> list)
+    : SegmentedVector(){
+        Reserve(list.size());
+        for(const T& value : list){
+            EmplaceBack(value);
+        }
+    }
+
+    SegmentedVector(const SegmentedVector& other)
+    : SegmentedVector(){
+        Reserve(other.size_);
+        for(const T& value : other){
+            EmplaceBack(value);
+        }
+    }
+
+    SegmentedVector(SegmentedVector&& other) noexcept {
+        Swap(other);
+    }
+
+    SegmentedVector& operator=(const SegmentedVector& rhs){
+        if(this != &rhs){
+            SegmentedVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    SegmentedVector& operator=(SegmentedVector&& rhs) noexcept {
+        if(this != &rhs){
+            Clear();
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    ~SegmentedVector(){
+        Clear();
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return Segments::Start(segment_count_);
+    }
+
+    // Выделяет сегменты под capacity элементов, не трогая существующие
+    void Reserve(size_t capacity){
+        while(Capacity() < capacity){
+            AddSegment();
+        }
+    }
+
+    void Resize(size_t new_size){
+        if(new_size <= size_){
+            while(size_ > new_size){
+                PopBack();
+            }
+        } else {
+            Reserve(new_size);
+            while(size_ < new_size){
+                EmplaceBack();
+            }
+        }
+    }
+
+    void PushBack(const T& value){
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value){
+        EmplaceBack(std::move(value));
+    }
+
+    // Элементы не перемещаются, поэтому аргументы могут ссылаться на элементы вектора
+    template <typename... Args>
+    T& EmplaceBack(Args&&... ctor_args){
+        if(size_ == Capacity()){
+            AddSegment();
+        }
+        T* const elem = new (Slot(size_)) T(std::forward<Args>(ctor_args)...);
+        ++size_;
+        return *elem;
+    }
+
+    void PopBack() noexcept {
+        assert(size_ != 0);
+        --size_;
+        std::destroy_at(Slot(size_));
+    }
+
+    // Удаляет все элементы, сохраняя выделенные сегменты
+    void Clear() noexcept {
+        for(size_t segment = 0; segment < segment_count_ && Segments::Start(segment) < size_; ++segment){
+            std::destroy_n(segments_[segment].GetAddress(),
+                           std::min(Segments::Size(segment), size_ - Segments::Start(segment)));
+        }
+        size_ = 0;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<SegmentedVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return *Slot(index);
+    }
+
+    iterator begin() noexcept {
+        return {this, 0};
+    }
+
+    iterator end() noexcept {
+        return {this, size_};
+    }
+
+    const_iterator begin() const noexcept {
+        return {this, 0};
+    }
+
+    const_iterator end() const noexcept {
+        return {this, size_};
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    void Swap(SegmentedVector& other) noexcept {
+        for(size_t segment = 0; segment < std::max(segment_count_, other.segment_count_); ++segment){
+            segments_[segment].Swap(other.segments_[segment]);
+        }
+        std::swap(segment_count_, other.segment_count_);
+        std::swap(size_, other.size_);
+    }
+
+private:
+    T* Slot(size_t index) noexcept {
+        const size_t segment = Segments::Of(index);
+        return segments_[segment].GetAddress() + (index - Segments::Start(segment));
+    }
+
+    void AddSegment(){
+        assert(segment_count_ < Segments::MAX_COUNT);
+        segments_[segment_count_] = RawMemory<T>(Segments::Size(segment_count_));
+        ++segment_count_;
+    }
+
+    RawMemory<T> segments_[Segments::MAX_COUNT];
+    size_t segment_count_ = 0;
+    size_t size_ = 0;
+};
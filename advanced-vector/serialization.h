@@ -0,0 +1,282 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Двоичная сериализация Vector в файловый дескриптор (файл, сокет, канал).
+// Поток вектора начинается с заголовка SerializationHeader, за которым следуют
+// элементы. Тривиально копируемые элементы записываются сырым буфером
+// в порядке байтов текущей платформы, остальные - пользовательской функцией
+
+struct SerializationHeader {
+    static constexpr uint32_t MAGIC = 0x56454356;  // "VCEV"
+    static constexpr uint32_t VERSION = 1;
+    // element_size потока, записанного поэлементно
+    static constexpr uint32_t VARIABLE_ELEMENT_SIZE = 0;
+
+    uint32_t magic = MAGIC;
+    uint32_t version = VERSION;
+    uint64_t size = 0;
+    uint32_t element_size = VARIABLE_ELEMENT_SIZE;
+    uint32_t reserved = 0;
+};
+
+// Буферизованная запись в дескриптор. Данные, записанные через Write,
+// попадают в дескриптор при вызове Flush или при следующей сериализации вектора
+class BinaryWriter {
+public:
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+    explicit BinaryWriter(int fd, size_t buffer_size = DEFAULT_BUFFER_SIZE)
+        : fd_(fd)
+        , buffer_(std::max<size_t>(buffer_size, 1), default_init){
+    }
+
+    BinaryWriter(const BinaryWriter&) = delete;
+    BinaryWriter& operator=(const BinaryWriter&) = delete;
+
+    void Write(const void* data, size_t size){
+        if(used_ + size > buffer_.Size()){
+            Flush();
+            if(size >= buffer_.Size()){
+                iovec part{const_cast<void*>(data), size};
+                WriteAll(&part, 1);
+                return;
+            }
+        }
+        std::memcpy(buffer_.begin() + used_, data, size);
+        used_ += size;
+    }
+
+    template <typename T>
+    void WriteValue(const T& value){
+        static_assert(std::is_trivially_copyable_v<T>);
+        Write(&value, sizeof(T));
+    }
+
+    // Записывает накопленные данные, head и body одним вызовом writev
+    void WriteBulk(const void* head, size_t head_size, const void* body, size_t body_size){
+        iovec parts[] = {
+            {buffer_.begin(), used_},
+            {const_cast<void*>(head), head_size},
+            {const_cast<void*>(body), body_size},
+        };
+        WriteAll(parts, 3);
+        used_ = 0;
+    }
+
+    void Flush(){
+        if(used_ != 0){
+            iovec part{buffer_.begin(), used_};
+            WriteAll(&part, 1);
+            used_ = 0;
+        }
+    }
+
+private:
+    // Дописывает остаток после частичной записи, что обычно для сокетов и каналов
+    void WriteAll(iovec* parts, int count){
+        while(count > 0){
+            if(parts->iov_len == 0){
+                ++parts;
+                --count;
+                continue;
+            }
+            const ssize_t written = writev(fd_, parts, count);
+            if(written < 0){
+                if(errno == EINTR){
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "writev failed");
+            }
+            size_t rest = static_cast<size_t>(written);
+            while(count > 0 && rest >= parts->iov_len){
+                rest -= parts->iov_len;
+                ++parts;
+                --count;
+            }
+            if(rest != 0){
+                parts->iov_base = static_cast<char*>(parts->iov_base) + rest;
+                parts->iov_len -= rest;
+            }
+        }
+    }
+
+    int fd_;
+    Vector<char> buffer_;
+    size_t used_ = 0;
+};
+
+// Буферизованное чтение из дескриптора. Может прочитать из дескриптора больше,
+// чем запрошено, поэтому весь поток следует читать через один BinaryReader
+class BinaryReader {
+public:
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+    explicit BinaryReader(int fd, size_t buffer_size = DEFAULT_BUFFER_SIZE)
+        : fd_(fd)
+        , buffer_(std::max<size_t>(buffer_size, 1), default_init){
+    }
+
+    BinaryReader(const BinaryReader&) = delete;
+    BinaryReader& operator=(const BinaryReader&) = delete;
+
+    // Читает ровно size байт. Большие блоки читаются напрямую в data, минуя буфер
+    void Read(void* data, size_t size){
+        char* out = static_cast<char*>(data);
+        while(size != 0){
+            if(begin_ == end_){
+                if(size >= buffer_.Size()){
+                    ReadDirect(out, size);
+                    return;
+                }
+                begin_ = 0;
+                end_ = ReadSome(buffer_.begin(), buffer_.Size());
+                if(end_ == 0){
+                    throw std::runtime_error("Unexpected end of stream");
+                }
+            }
+            const size_t chunk = std::min(size, end_ - begin_);
+            std::memcpy(out, buffer_.begin() + begin_, chunk);
+            begin_ += chunk;
+            out += chunk;
+            size -= chunk;
+        }
+    }
+
+    template <typename T>
+    T ReadValue(){
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value;
+        Read(&value, sizeof(T));
+        return value;
+    }
+
+private:
+    void ReadDirect(char* out, size_t size){
+        while(size != 0){
+            const size_t count = ReadSome(out, size);
+            if(count == 0){
+                throw std::runtime_error("Unexpected end of stream");
+            }
+            out += count;
+            size -= count;
+        }
+    }
+
+    size_t ReadSome(char* out, size_t size){
+        for(;;){
+            const ssize_t count = read(fd_, out, size);
+            if(count >= 0){
+                return static_cast<size_t>(count);
+            }
+            if(errno != EINTR){
+                throw std::system_error(errno, std::generic_category(), "read failed");
+            }
+        }
+    }
+
+    int fd_;
+    Vector<char> buffer_;
+    size_t begin_ = 0;
+    size_t end_ = 0;
+};
+
+namespace detail {
+
+// Сколько байт Deserialize выделяет заранее. Размер из заголовка не проверить
+// до чтения элементов, поэтому сверх этого память растёт вместе с прочитанными данными
+inline constexpr size_t DESERIALIZE_RESERVE_BYTES = 1024 * 1024;
+
+template <typename T>
+constexpr size_t MaxReservedElements() noexcept {
+    return std::max<size_t>(DESERIALIZE_RESERVE_BYTES / sizeof(T), 1);
+}
+
+inline SerializationHeader ReadSerializationHeader(BinaryReader& in, uint32_t element_size){
+    const auto header = in.ReadValue<SerializationHeader>();
+    if(header.magic != SerializationHeader::MAGIC){
+        throw std::runtime_error("Stream does not contain a serialized Vector");
+    }
+    if(header.version != SerializationHeader::VERSION){
+        throw std::runtime_error("Unsupported serialization version");
+    }
+    if(header.element_size != element_size){
+        throw std::runtime_error("Serialized element size does not match");
+    }
+    return header;
+}
+
+}  // namespace detail
+
+// Записывает заголовок и буфер элементов одним вызовом writev
+template <typename T, typename... Params>
+void Serialize(BinaryWriter& out, const Vector<T, Params...>& vector){
+    static_assert(std::is_trivially_copyable_v<T>, "Pass an element writer for non-trivially copyable types");
+    SerializationHeader header;
+    header.size = vector.Size();
+    header.element_size = sizeof(T);
+    out.WriteBulk(&header, sizeof(header), vector.begin(), vector.Size() * sizeof(T));
+}
+
+// Записывает каждый элемент вызовом write_element(out, element)
+template <typename T, typename... Params, typename ElementWriter>
+void Serialize(BinaryWriter& out, const Vector<T, Params...>& vector, ElementWriter write_element){
+    SerializationHeader header;
+    header.size = vector.Size();
+    out.WriteValue(header);
+    for(const T& element : vector){
+        write_element(out, element);
+    }
+    out.Flush();
+}
+
+// Заменяет содержимое vector чтением в неинициализированную память: до
+// DESERIALIZE_RESERVE_BYTES байт одним чтением, а сверх них - порциями, удваивающими
+// размер, так что повреждённый заголовок не вызывает огромного выделения.
+// При исключении vector остаётся пустым
+template <typename T, typename... Params>
+void Deserialize(BinaryReader& in, Vector<T, Params...>& vector){
+    static_assert(std::is_trivially_copyable_v<T>, "Pass an element reader for non-trivially copyable types");
+    const auto header = detail::ReadSerializationHeader(in, sizeof(T));
+    if(header.size > std::numeric_limits<size_t>::max() / sizeof(T)){
+        throw std::runtime_error("Serialized Vector is too large");
+    }
+    const size_t size = static_cast<size_t>(header.size);
+    vector.Clear();
+    try {
+        for(size_t done = 0; done < size;){
+            const size_t next = std::min(size, std::max(done * 2, detail::MaxReservedElements<T>()));
+            vector.ResizeAndOverwrite(next, [&in, done](T* data, size_t count) {
+                in.Read(data + done, (count - done) * sizeof(T));
+                return count;
+            });
+            done = next;
+        }
+    } catch(...){
+        vector.Clear();
+        throw;
+    }
+}
+
+// Заменяет содержимое vector элементами, возвращёнными read_element(in).
+// При исключении vector содержит уже прочитанные элементы
+template <typename T, typename... Params, typename ElementReader>
+void Deserialize(BinaryReader& in, Vector<T, Params...>& vector, ElementReader read_element){
+    const auto header = detail::ReadSerializationHeader(in, SerializationHeader::VARIABLE_ELEMENT_SIZE);
+    vector.Clear();
+    vector.Reserve(static_cast<size_t>(std::min<uint64_t>(header.size, detail::MaxReservedElements<T>())));
+    for(uint64_t i = 0; i < header.size; ++i){
+        vector.EmplaceBack(read_element(in));
+    }
+}
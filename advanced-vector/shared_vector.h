@@ -0,0 +1,318 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <initializer_list>
+#include <utility>
+
+// Вектор с копированием при записи. Копии SharedVector делят один Vector
+// со счётчиком ссылок, поэтому копирование занимает O(1) и не трогает элементы.
+// Изменяющие методы сначала отделяют собственную копию, если буфер разделён.
+// Счётчик атомарный: копии можно передавать в другие потоки и читать и изменять
+// там независимо. Один и тот же объект SharedVector, как и std::shared_ptr,
+// нельзя без синхронизации изменять из одного потока и копировать из другого.
+// Итераторы и ссылки, полученные из вектора, инвалидируются при отделении.
+// После выдачи изменяемой ссылки или итератора буфер, как «утёкшая» COW-строка
+// libstdc++, больше не разделяется: копии получают собственный буфер, пока
+// перевыделение не сделает выданные ссылки недействительными. Ссылка из Mutable()
+// переживает любое перевыделение, поэтому такой буфер не разделяется уже никогда
+template <typename T>
+class SharedVector {
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SharedVector() noexcept = default;
+
+    explicit SharedVector(Vector<T> data)
+    : block_(new Block(std::move(data))){
+    }
+
+    SharedVector(std::initializer_list<T> list)
+    : SharedVector(Vector<T>(list)){
+    }
+
+    SharedVector(const SharedVector& other){
+        if(other.block_ == nullptr){
+            return;
+        }
+        if(other.block_->shareable && !other.block_->leaked){
+            block_ = other.block_;
+            block_->refs.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            block_ = Copy(*other.block_, other.Size());
+        }
+    }
+
+    SharedVector(SharedVector&& other) noexcept {
+        Swap(other);
+    }
+
+    SharedVector& operator=(const SharedVector& rhs){
+        if(this != &rhs){
+            SharedVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    SharedVector& operator=(SharedVector&& rhs) noexcept {
+        if(this != &rhs){
+            Release();
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    ~SharedVector(){
+        Release();
+    }
+
+    size_t Size() const noexcept {
+        return block_ != nullptr ? block_->data.Size() : 0;
+    }
+
+    bool IsEmpty() const noexcept {
+        return Size() == 0;
+    }
+
+    size_t Capacity() const noexcept {
+        return block_ != nullptr ? block_->data.Capacity() : 0;
+    }
+
+    // Число SharedVector, разделяющих буфер
+    size_t UseCount() const noexcept {
+        return block_ != nullptr ? block_->refs.load(std::memory_order_acquire) : 0;
+    }
+
+    bool IsShared() const noexcept {
+        return UseCount() > 1;
+    }
+
+    void Reserve(size_t new_capacity){
+        Detach(new_capacity);
+    }
+
+    void Resize(size_t new_size){
+        Detach(new_size);
+        block_->data.Resize(new_size);
+    }
+
+    // PushBack не выдаёт ссылок и оставляет буфер разделяемым
+    void PushBack(const T& value){
+        Append(value);
+    }
+
+    void PushBack(T&& value){
+        Append(std::move(value));
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... ctor_args){
+        T& elem = Append(std::forward<Args>(ctor_args)...);
+        Leak();
+        return elem;
+    }
+
+    void PopBack(){
+        assert(Size() != 0);
+        Detach(Size());
+        block_->data.PopBack();
+    }
+
+    iterator Insert(const_iterator pos, const T& value){
+        return Emplace(pos, value);
+    }
+
+    iterator Insert(const_iterator pos, T&& value){
+        return Emplace(pos, std::move(value));
+    }
+
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... ctor_args){
+        const size_t index = IndexOf(pos);
+        if(IsShared()){
+            // Значение строится до отделения: аргументы могут ссылаться на разделённый буфер
+            T value(std::forward<Args>(ctor_args)...);
+            Detach(Grown());
+            Leak();
+            return block_->data.Emplace(block_->data.cbegin() + index, std::move(value));
+        }
+        Detach(Size());
+        Leak();
+        return block_->data.Emplace(block_->data.cbegin() + index, std::forward<Args>(ctor_args)...);
+    }
+
+    iterator Erase(const_iterator pos){
+        const size_t index = IndexOf(pos);
+        Detach(Size());
+        Leak();
+        return block_->data.Erase(block_->data.cbegin() + index);
+    }
+
+    iterator Erase(const_iterator first, const_iterator last){
+        const size_t first_index = IndexOf(first);
+        const size_t last_index = IndexOf(last);
+        Detach(Size());
+        Leak();
+        return block_->data.Erase(block_->data.cbegin() + first_index, block_->data.cbegin() + last_index);
+    }
+
+    // Разделённый буфер не копируется, а просто отпускается
+    void Clear() noexcept {
+        if(IsShared()){
+            Release();
+        } else if(block_ != nullptr){
+            block_->data.Clear();
+        }
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < Size());
+        return block_->data[index];
+    }
+
+    // Отделяет копию, если буфер разделён
+    T& operator[](size_t index){
+        assert(index < Size());
+        Detach(Size());
+        Leak();
+        return block_->data[index];
+    }
+
+    // Отделяет копию и открывает её для произвольных изменений
+    Vector<T>& Mutable(){
+        Detach(Size());
+        block_->leaked = true;
+        return block_->data;
+    }
+
+    // Итераторы только константные, чтобы обход не приводил к отделению копии
+    const_iterator begin() const noexcept {
+        return block_ != nullptr ? block_->data.begin() : nullptr;
+    }
+
+    const_iterator end() const noexcept {
+        return block_ != nullptr ? block_->data.end() : nullptr;
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    void Swap(SharedVector& other) noexcept {
+        std::swap(block_, other.block_);
+    }
+
+private:
+    struct Block {
+        explicit Block(Vector<T> data)
+        : data(std::move(data)){
+        }
+
+        std::atomic<size_t> refs = 1;
+        // false, пока живы выданные изменяемые ссылки; такой блок всегда принадлежит
+        // одному SharedVector, поэтому флаг меняет и читает только его владелец
+        bool shareable = true;
+        // true, если выдана ссылка на сам Vector: она переживает перевыделение,
+        // поэтому этот флаг, в отличие от shareable, не сбрасывается никогда
+        bool leaked = false;
+        Vector<T> data;
+    };
+
+    size_t IndexOf(const_iterator pos) const noexcept {
+        assert(pos >= begin() && pos <= end());
+        return pos - begin();
+    }
+
+    // Вместимость отделяемой копии, в которую помещается ещё один элемент
+    size_t Grown() const noexcept {
+        return Size() == Capacity() ? DoublingGrowth::NextCapacity(Capacity(), sizeof(T)) : Capacity();
+    }
+
+    static Block* Copy(const Block& block, size_t capacity){
+        Vector<T> data;
+        data.Reserve(std::max(capacity, block.data.Size()));
+        data.Insert(data.cend(), block.data.begin(), block.data.end());
+        return new Block(std::move(data));
+    }
+
+    // Отделяемая копия сразу получает место под новый элемент. Аргументы
+    // могут ссылаться на элементы вектора: разделённый буфер не меняется,
+    // а собственный буфер Vector::EmplaceBack обрабатывает сам
+    template <typename... Args>
+    T& Append(Args&&... ctor_args){
+        if(IsShared()){
+            Block* const old_block = block_;
+            block_ = Copy(*old_block, Grown());
+            T& elem = EmplaceOrRollback(old_block, std::forward<Args>(ctor_args)...);
+            ReleaseBlock(old_block);
+            return elem;
+        }
+        Detach(Size());
+        const T* const old_data = block_->data.begin();
+        T& elem = block_->data.EmplaceBack(std::forward<Args>(ctor_args)...);
+        ResetIfReallocated(old_data);
+        return elem;
+    }
+
+    // Запрещает разделять буфер, в который выдана изменяемая ссылка
+    void Leak() noexcept {
+        block_->shareable = false;
+    }
+
+    // Перевыделение инвалидирует выданные ссылки, и буфер снова можно разделять
+    void ResetIfReallocated(const T* old_data) noexcept {
+        if(block_->data.begin() != old_data){
+            block_->shareable = true;
+        }
+    }
+
+    template <typename... Args>
+    T& EmplaceOrRollback(Block* old_block, Args&&... ctor_args){
+        try {
+            return block_->data.EmplaceBack(std::forward<Args>(ctor_args)...);
+        } catch(...){
+            delete block_;
+            block_ = old_block;
+            throw;
+        }
+    }
+
+    // Гарантирует, что буфер принадлежит только *this и вмещает capacity элементов
+    void Detach(size_t capacity){
+        if(block_ == nullptr){
+            block_ = new Block(Vector<T>());
+            block_->data.Reserve(capacity);
+        } else if(IsShared()){
+            Block* const copy = Copy(*block_, capacity);
+            ReleaseBlock(block_);
+            block_ = copy;
+        } else {
+            const T* const old_data = block_->data.begin();
+            block_->data.Reserve(capacity);
+            ResetIfReallocated(old_data);
+        }
+    }
+
+    // Последний владелец видит все изменения остальных благодаря acq_rel
+    static void ReleaseBlock(Block* block) noexcept {
+        if(block != nullptr && block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1){
+            delete block;
+        }
+    }
+
+    void Release() noexcept {
+        ReleaseBlock(block_);
+        block_ = nullptr;
+    }
+
+    Block* block_ = nullptr;
+};
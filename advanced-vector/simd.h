@@ -0,0 +1,392 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+
+// Векторизованные ядра поиска, подсчёта, сравнения, заполнения, поиска минимума
+// и максимума и суммирования для арифметических типов.
+// Ядра написаны на векторных расширениях GCC/Clang и компилируются под несколько
+// наборов инструкций: SSE2/NEON (базовый), AVX2 и AVX-512. Нужный вариант выбирается
+// во время выполнения по возможностям процессора, для остальных типов и компиляторов
+// используются скалярные алгоритмы стандартной библиотеки
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define VECTOR_SIMD_X86 1
+#elif defined(__GNUC__) && defined(__ARM_NEON)
+#define VECTOR_SIMD_NEON 1
+#endif
+
+namespace simd {
+
+enum class Level {
+    SCALAR,
+    BASE,
+    AVX2,
+    AVX512
+};
+
+namespace detail {
+
+template <typename T, typename... Ts>
+inline constexpr bool is_one_of_v = (std::is_same_v<T, Ts> || ...);
+
+// Тип, в котором Sum складывает элементы. Целые складываются без знака: переполнение
+// знаковых - UB, а результат по модулю 2^N от порядка сложения не зависит
+template <typename T, bool = std::is_integral_v<T> && !std::is_same_v<T, bool>>
+struct SumType {
+    using type = T;
+};
+
+template <typename T>
+struct SumType<T, true> {
+    using type = std::make_unsigned_t<T>;
+};
+
+template <typename T>
+using SumType_t = typename SumType<T>::type;
+
+}  // namespace detail
+
+// Типы, для которых есть векторные ядра
+template <typename T>
+inline constexpr bool is_simd_element_v = detail::is_one_of_v<T,
+    char, signed char, unsigned char, short, unsigned short, int, unsigned int,
+    long, unsigned long, long long, unsigned long long, float, double>;
+
+inline Level DetectLevel() noexcept {
+#if defined(VECTOR_SIMD_X86)
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")){
+        return Level::AVX512;
+    }
+    if(__builtin_cpu_supports("avx2")){
+        return Level::AVX2;
+    }
+    return Level::BASE;
+#elif defined(VECTOR_SIMD_NEON)
+    return Level::BASE;
+#else
+    return Level::SCALAR;
+#endif
+}
+
+namespace detail {
+
+inline std::atomic<Level>& CurrentLevel() noexcept {
+    static std::atomic<Level> level{DetectLevel()};
+    return level;
+}
+
+}  // namespace detail
+
+inline Level ActiveLevel() noexcept {
+    return detail::CurrentLevel().load(std::memory_order_relaxed);
+}
+
+// Ограничивает используемый набор инструкций, например для сравнения со скалярной
+// версией. Уровень выше поддерживаемого процессором не включается
+inline void LimitLevel(Level level) noexcept {
+    detail::CurrentLevel().store(std::min(level, DetectLevel()), std::memory_order_relaxed);
+}
+
+namespace detail {
+
+#if defined(VECTOR_SIMD_X86) || defined(VECTOR_SIMD_NEON)
+
+// Ядра встраиваются в обёртки с атрибутом target, поэтому векторы шириной Bytes
+// компилируются инструкциями соответствующего набора
+#define VECTOR_SIMD_KERNEL __attribute__((always_inline)) inline
+
+template <typename T, size_t Bytes>
+struct Lanes {
+    typedef T Vec __attribute__((vector_size(Bytes)));
+    typedef long long Wide __attribute__((vector_size(Bytes)));
+    static constexpr size_t COUNT = Bytes / sizeof(T);
+};
+
+template <size_t Bytes, typename Mask>
+VECTOR_SIMD_KERNEL bool AnyLane(const Mask& mask) {
+    typename Lanes<long long, Bytes>::Wide wide;
+    std::memcpy(&wide, &mask, Bytes);
+    long long any = 0;
+    for(size_t i = 0; i < Bytes / sizeof(long long); ++i){
+        any |= wide[i];
+    }
+    return any != 0;
+}
+
+template <typename T, size_t Bytes>
+VECTOR_SIMD_KERNEL size_t FindKernel(const T* data, size_t size, T value) {
+    using Vec = typename Lanes<T, Bytes>::Vec;
+    constexpr size_t N = Lanes<T, Bytes>::COUNT;
+    const Vec needle = Vec{} + value;
+    size_t i = 0;
+    for(; i + N <= size; i += N){
+        Vec block;
+        std::memcpy(&block, data + i, Bytes);
+        if(AnyLane<Bytes>(block == needle)){
+            break;
+        }
+    }
+    for(; i < size; ++i){
+        if(data[i] == value){
+            return i;
+        }
+    }
+    return size;
+}
+
+template <typename T, size_t Bytes>
+VECTOR_SIMD_KERNEL size_t CountKernel(const T* data, size_t size, T value) {
+    using Vec = typename Lanes<T, Bytes>::Vec;
+    using Mask = decltype(Vec{} == Vec{});
+    using MaskLane = std::remove_cv_t<std::remove_reference_t<decltype(Mask{}[0])>>;
+    constexpr size_t N = Lanes<T, Bytes>::COUNT;
+    // Узкие счётчики периодически сбрасываются в общий, чтобы не переполниться
+    constexpr size_t MAX_BLOCKS = static_cast<size_t>(std::numeric_limits<MaskLane>::max());
+    const Vec needle = Vec{} + value;
+    size_t count = 0;
+    size_t i = 0;
+    while(i + N <= size){
+        const size_t blocks = std::min((size - i) / N, MAX_BLOCKS);
+        Mask matches{};
+        for(size_t b = 0; b < blocks; ++b, i += N){
+            Vec block;
+            std::memcpy(&block, data + i, Bytes);
+            // Совпавшие дорожки маски равны -1
+            matches -= block == needle;
+        }
+        for(size_t j = 0; j < N; ++j){
+            count += static_cast<size_t>(matches[j]);
+        }
+    }
+    for(; i < size; ++i){
+        count += data[i] == value;
+    }
+    return count;
+}
+
+template <typename T, size_t Bytes>
+VECTOR_SIMD_KERNEL bool EqualKernel(const T* lhs, const T* rhs, size_t size) {
+    using Vec = typename Lanes<T, Bytes>::Vec;
+    constexpr size_t N = Lanes<T, Bytes>::COUNT;
+    size_t i = 0;
+    for(; i + N <= size; i += N){
+        Vec a;
+        Vec b;
+        std::memcpy(&a, lhs + i, Bytes);
+        std::memcpy(&b, rhs + i, Bytes);
+        if(AnyLane<Bytes>(a != b)){
+            return false;
+        }
+    }
+    for(; i < size; ++i){
+        if(lhs[i] != rhs[i]){
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T, size_t Bytes>
+VECTOR_SIMD_KERNEL void FillKernel(T* data, size_t size, T value) {
+    using Vec = typename Lanes<T, Bytes>::Vec;
+    constexpr size_t N = Lanes<T, Bytes>::COUNT;
+    const Vec block = Vec{} + value;
+    size_t i = 0;
+    for(; i + N <= size; i += N){
+        std::memcpy(data + i, &block, Bytes);
+    }
+    for(; i < size; ++i){
+        data[i] = value;
+    }
+}
+
+template <typename T, size_t Bytes>
+VECTOR_SIMD_KERNEL std::pair<T, T> MinMaxKernel(const T* data, size_t size) {
+    using Vec = typename Lanes<T, Bytes>::Vec;
+    constexpr size_t N = Lanes<T, Bytes>::COUNT;
+    Vec low = Vec{} + data[0];
+    Vec high = low;
+    size_t i = 0;
+    for(; i + N <= size; i += N){
+        Vec block;
+        std::memcpy(&block, data + i, Bytes);
+        low = block < low ? block : low;
+        high = high < block ? block : high;
+    }
+    T min = low[0];
+    T max = high[0];
+    for(size_t j = 1; j < N; ++j){
+        min = low[j] < min ? low[j] : min;
+        max = max < high[j] ? high[j] : max;
+    }
+    for(; i < size; ++i){
+        min = data[i] < min ? data[i] : min;
+        max = max < data[i] ? data[i] : max;
+    }
+    return {min, max};
+}
+
+template <typename T, size_t Bytes>
+VECTOR_SIMD_KERNEL T SumKernel(const T* data, size_t size) {
+    using Acc = SumType_t<T>;
+    using Vec = typename Lanes<Acc, Bytes>::Vec;
+    constexpr size_t N = Lanes<Acc, Bytes>::COUNT;
+    Vec acc{};
+    size_t i = 0;
+    for(; i + N <= size; i += N){
+        Vec block;
+        std::memcpy(&block, data + i, Bytes);
+        acc += block;
+    }
+    Acc sum{};
+    for(size_t j = 0; j < N; ++j){
+        sum += acc[j];
+    }
+    for(; i < size; ++i){
+        sum += static_cast<Acc>(data[i]);
+    }
+    return static_cast<T>(sum);
+}
+
+#define VECTOR_SIMD_DEFINE_LEVEL(SUFFIX, ATTRIBUTES, BYTES)                                          \
+    template <typename T>                                                                            \
+    ATTRIBUTES size_t Find##SUFFIX(const T* data, size_t size, T value) {                            \
+        return FindKernel<T, BYTES>(data, size, value);                                              \
+    }                                                                                                \
+    template <typename T>                                                                            \
+    ATTRIBUTES size_t Count##SUFFIX(const T* data, size_t size, T value) {                           \
+        return CountKernel<T, BYTES>(data, size, value);                                             \
+    }                                                                                                \
+    template <typename T>                                                                            \
+    ATTRIBUTES bool Equal##SUFFIX(const T* lhs, const T* rhs, size_t size) {                         \
+        return EqualKernel<T, BYTES>(lhs, rhs, size);                                                \
+    }                                                                                                \
+    template <typename T>                                                                            \
+    ATTRIBUTES void Fill##SUFFIX(T* data, size_t size, T value) {                                    \
+        FillKernel<T, BYTES>(data, size, value);                                                     \
+    }                                                                                                \
+    template <typename T>                                                                            \
+    ATTRIBUTES std::pair<T, T> MinMax##SUFFIX(const T* data, size_t size) {                          \
+        return MinMaxKernel<T, BYTES>(data, size);                                                   \
+    }                                                                                                \
+    template <typename T>                                                                            \
+    ATTRIBUTES T Sum##SUFFIX(const T* data, size_t size) {                                           \
+        return SumKernel<T, BYTES>(data, size);                                                      \
+    }
+
+VECTOR_SIMD_DEFINE_LEVEL(Base, , 16)
+#if defined(VECTOR_SIMD_X86)
+VECTOR_SIMD_DEFINE_LEVEL(Avx2, __attribute__((target("avx2"))), 32)
+VECTOR_SIMD_DEFINE_LEVEL(Avx512, __attribute__((target("avx512f,avx512bw"))), 64)
+#endif
+
+#undef VECTOR_SIMD_DEFINE_LEVEL
+#undef VECTOR_SIMD_KERNEL
+
+#endif
+
+}  // namespace detail
+
+#if defined(VECTOR_SIMD_X86)
+#define VECTOR_SIMD_DISPATCH(NAME, ...)            \
+    switch(ActiveLevel()){                         \
+    case Level::AVX512:                            \
+        return detail::NAME##Avx512(__VA_ARGS__);  \
+    case Level::AVX2:                              \
+        return detail::NAME##Avx2(__VA_ARGS__);    \
+    case Level::BASE:                              \
+        return detail::NAME##Base(__VA_ARGS__);    \
+    case Level::SCALAR:                            \
+        break;                                     \
+    }
+#elif defined(VECTOR_SIMD_NEON)
+#define VECTOR_SIMD_DISPATCH(NAME, ...)            \
+    if(ActiveLevel() != Level::SCALAR){            \
+        return detail::NAME##Base(__VA_ARGS__);    \
+    }
+#else
+#define VECTOR_SIMD_DISPATCH(NAME, ...)
+#endif
+
+// Индекс первого элемента, равного value, либо size
+template <typename T>
+size_t Find(const T* data, size_t size, const T& value) {
+    if constexpr(is_simd_element_v<T>){
+        VECTOR_SIMD_DISPATCH(Find, data, size, value)
+    }
+    return std::find(data, data + size, value) - data;
+}
+
+template <typename T>
+bool Contains(const T* data, size_t size, const T& value) {
+    return Find(data, size, value) != size;
+}
+
+template <typename T>
+size_t Count(const T* data, size_t size, const T& value) {
+    if constexpr(is_simd_element_v<T>){
+        VECTOR_SIMD_DISPATCH(Count, data, size, value)
+    }
+    return std::count(data, data + size, value);
+}
+
+template <typename T>
+bool Equal(const T* lhs, const T* rhs, size_t size) {
+    if constexpr(std::is_integral_v<T> && is_simd_element_v<T>){
+        // Для целых чисел равенство совпадает с побайтовым
+        return size == 0 || std::memcmp(lhs, rhs, size * sizeof(T)) == 0;
+    } else if constexpr(is_simd_element_v<T>){
+        VECTOR_SIMD_DISPATCH(Equal, lhs, rhs, size)
+    }
+    return std::equal(lhs, lhs + size, rhs);
+}
+
+template <typename T>
+void Fill(T* data, size_t size, const T& value) {
+    if constexpr(is_simd_element_v<T>){
+        VECTOR_SIMD_DISPATCH(Fill, data, size, value)
+    }
+    std::fill_n(data, size, value);
+}
+
+// Пара (минимум, максимум) непустого диапазона. Для чисел с плавающей точкой
+// результат с NaN не определён
+template <typename T>
+std::pair<T, T> MinMax(const T* data, size_t size) {
+    assert(size != 0);
+    if constexpr(is_simd_element_v<T>){
+        VECTOR_SIMD_DISPATCH(MinMax, data, size)
+    }
+    const auto [min, max] = std::minmax_element(data, data + size);
+    return {*min, *max};
+}
+
+// Сумма элементов в типе T. Целые складываются по модулю 2^N, как беззнаковые.
+// Для чисел с плавающей точкой порядок сложения отличается от последовательного,
+// поэтому результат может различаться в младших битах
+template <typename T>
+T Sum(const T* data, size_t size) {
+    if constexpr(is_simd_element_v<T>){
+        VECTOR_SIMD_DISPATCH(Sum, data, size)
+    }
+    using Acc = detail::SumType_t<T>;
+    if constexpr(!std::is_same_v<Acc, T>){
+        return static_cast<T>(std::accumulate(data, data + size, Acc{}, [](Acc sum, T value) {
+            return static_cast<Acc>(sum + static_cast<Acc>(value));
+        }));
+    } else {
+        return std::accumulate(data, data + size, T{});
+    }
+}
+
+#undef VECTOR_SIMD_DISPATCH
+
+}  // namespace simd
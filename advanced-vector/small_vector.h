@@ -0,0 +1,259 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+// Вектор, хранящий до N элементов внутри самого объекта. При превышении N
+// элементы переносятся в динамическую память RawMemory и остаются там
+template <typename T, size_t N, typename GrowthPolicy = DoublingGrowth>
+class SmallVector {
+    static_assert(N > 0, "Inline capacity must be positive");
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() noexcept = default;
+
+    explicit SmallVector(size_t size){
+        Reserve(size);
+        std::uninitialized_value_construct_n(Data(), size);
+        size_ = size;
+    }
+
+    SmallVector(std::initializer_list<T> list){
+        Reserve(list.size());
+        std::uninitialized_copy_n(list.begin(), list.size(), Data());
+        size_ = list.size();
+    }
+
+    SmallVector(const SmallVector& other){
+        Reserve(other.size_);
+        std::uninitialized_copy_n(other.Data(), other.size_, Data());
+        size_ = other.size_;
+    }
+
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>){
+        TakeElements(other);
+    }
+
+    SmallVector& operator=(const SmallVector& rhs){
+        if(this != &rhs){
+            if(rhs.size_ > Capacity()){
+                SmallVector rhs_copy(rhs);
+                *this = std::move(rhs_copy);
+            } else {
+                const size_t common = std::min(size_, rhs.size_);
+                std::copy_n(rhs.Data(), common, Data());
+                if(rhs.size_ > size_){
+                    std::uninitialized_copy_n(rhs.Data() + size_, rhs.size_ - size_, Data() + size_);
+                } else {
+                    std::destroy_n(Data() + rhs.size_, size_ - rhs.size_);
+                }
+                size_ = rhs.size_;
+            }
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>){
+        if(this != &rhs){
+            std::destroy_n(Data(), size_);
+            size_ = 0;
+            TakeElements(rhs);
+        }
+        return *this;
+    }
+
+    ~SmallVector(){
+        std::destroy_n(Data(), size_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return IsInline() ? N : heap_.Capacity();
+    }
+
+    // Элементы хранятся в самом объекте, без обращения к динамической памяти
+    bool IsInline() const noexcept {
+        return heap_.GetAddress() == nullptr;
+    }
+
+    void Reserve(size_t new_capacity){
+        if(new_capacity <= Capacity()){
+            return;
+        }
+
+        RawMemory<T> new_data(new_capacity);
+        UninitializedRelocateN(Data(), size_, new_data.GetAddress());
+        DestroyRelocatedN(Data(), size_);
+        heap_.Swap(new_data);
+    }
+
+    void Resize(size_t new_size){
+        if(new_size <= size_){
+            std::destroy_n(Data() + new_size, size_ - new_size);
+        } else {
+            Reserve(new_size);
+            std::uninitialized_value_construct_n(Data() + size_, new_size - size_);
+        }
+        size_ = new_size;
+    }
+
+    void PushBack(const T& value){
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value){
+        EmplaceBack(std::move(value));
+    }
+
+    iterator Insert(const_iterator pos, const T& value){
+        return Emplace(pos, value);
+    }
+
+    iterator Insert(const_iterator pos, T&& value){
+        return Emplace(pos, std::move(value));
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... ctor_args){
+        if(size_ == Capacity()){
+            EmplaceWithReallocation(size_, std::forward<Args>(ctor_args)...);
+        } else {
+            new (Data() + size_) T(std::forward<Args>(ctor_args)...);
+            ++size_;
+        }
+        return Data()[size_ - 1];
+    }
+
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... ctor_args){
+        const size_t index = pos - Data();
+        assert(index <= size_);
+
+        if(size_ == Capacity()){
+            EmplaceWithReallocation(index, std::forward<Args>(ctor_args)...);
+        } else if(index == size_){
+            new (Data() + size_) T(std::forward<Args>(ctor_args)...);
+            ++size_;
+        } else {
+            T elem(std::forward<Args>(ctor_args)...);
+            new (end()) T(std::move(Data()[size_ - 1]));
+            ++size_;
+            std::move_backward(begin() + index, end() - 2, end() - 1);
+            Data()[index] = std::move(elem);
+        }
+        return begin() + index;
+    }
+
+    iterator Erase(const_iterator pos){
+        const size_t index = pos - Data();
+        assert(index < size_);
+        std::move(begin() + index + 1, end(), begin() + index);
+        PopBack();
+        return begin() + index;
+    }
+
+    void PopBack() noexcept{
+        assert(size_ != 0);
+        std::destroy_at(Data() + size_ - 1);
+        --size_;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<SmallVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    iterator begin() noexcept{
+        return Data();
+    }
+
+    iterator end() noexcept{
+        return Data() + size_;
+    }
+
+    const_iterator begin() const noexcept{
+        return Data();
+    }
+
+    const_iterator end() const noexcept{
+        return Data() + size_;
+    }
+
+    const_iterator cbegin() const noexcept{
+        return Data();
+    }
+
+    const_iterator cend() const noexcept{
+        return Data() + size_;
+    }
+
+    void Swap(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T>){
+        SmallVector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+private:
+    T* Data() noexcept{
+        return IsInline() ? std::launder(reinterpret_cast<T*>(inline_data_)) : heap_.GetAddress();
+    }
+
+    const T* Data() const noexcept{
+        return const_cast<SmallVector&>(*this).Data();
+    }
+
+    // Забирает элементы other, оставляя его пустым. Ожидает, что *this пуст
+    void TakeElements(SmallVector& other){
+        assert(size_ == 0);
+        if(other.IsInline()){
+            UninitializedRelocateN(other.Data(), other.size_, Data());
+            DestroyRelocatedN(other.Data(), other.size_);
+        } else {
+            heap_ = std::move(other.heap_);
+        }
+        size_ = other.size_;
+        other.size_ = 0;
+    }
+
+    // Строит элемент на позиции index в новом буфере и переносит туда остальные.
+    // При исключении вектор остаётся в прежнем состоянии
+    template <typename... Args>
+    void EmplaceWithReallocation(size_t index, Args&&... ctor_args){
+        RawMemory<T> new_data(GrowthPolicy::NextCapacity(Capacity(), sizeof(T)));
+        T* const old_data = Data();
+        T* const new_elem = new (new_data + index) T(std::forward<Args>(ctor_args)...);
+        try {
+            UninitializedRelocateN(old_data, index, new_data.GetAddress());
+        } catch(...){
+            std::destroy_at(new_elem);
+            throw;
+        }
+        try {
+            UninitializedRelocateN(old_data + index, size_ - index, new_elem + 1);
+        } catch(...){
+            std::destroy_n(new_data.GetAddress(), index + 1);
+            throw;
+        }
+        DestroyRelocatedN(old_data, size_);
+        heap_.Swap(new_data);
+        ++size_;
+    }
+
+    RawMemory<T> heap_;
+    alignas(T) unsigned char inline_data_[N * sizeof(T)];
+    size_t size_ = 0;
+};
@@ -0,0 +1,289 @@
+#pragma once
+#include "vector.h"
+
+#include <cassert>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Вектор строк из полей Ts..., хранящий каждое поле в отдельном буфере RawMemory
+// (структура массивов). Цикл, читающий одно поле, проходит по непрерывному массиву
+// этого поля и не загружает в кэш остальные. Data<I>() открывает массив поля I,
+// например, для simd::Sum, а operator[] возвращает строку как кортеж ссылок.
+// Гарантии безопасности исключений совпадают с гарантиями Vector
+template <typename... Ts>
+class SoaVector {
+    static_assert(sizeof...(Ts) > 0, "SoaVector requires at least one field");
+    using Columns = std::tuple<RawMemory<Ts>...>;
+    using Indices = std::index_sequence_for<Ts...>;
+
+    template <size_t I>
+    using Field = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    // Перенос поля может бросить исключение, только если оно копируется
+    template <size_t I>
+    static constexpr bool MAY_THROW_ON_RELOCATE = !is_trivially_relocatable_v<Field<I>>
+                                                  && !std::is_nothrow_move_constructible_v<Field<I>>
+                                                  && std::is_copy_constructible_v<Field<I>>;
+
+public:
+    using Row = std::tuple<Ts&...>;
+    using ConstRow = std::tuple<const Ts&...>;
+
+    static constexpr size_t FIELD_COUNT = sizeof...(Ts);
+
+    SoaVector() noexcept = default;
+
+    explicit SoaVector(size_t size)
+    : SoaVector(){
+        Resize(size);
+    }
+
+    SoaVector(const SoaVector& other)
+    : SoaVector(){
+        Reserve(other.size_);
+        for(size_t i = 0; i < other.size_; ++i){
+            std::apply([this](const Ts&... fields) {
+                EmplaceBack(fields...);
+            }, other[i]);
+        }
+    }
+
+    SoaVector(SoaVector&& other) noexcept {
+        Swap(other);
+    }
+
+    SoaVector& operator=(const SoaVector& rhs){
+        if(this != &rhs){
+            SoaVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    SoaVector& operator=(SoaVector&& rhs) noexcept {
+        if(this != &rhs){
+            Clear();
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    ~SoaVector(){
+        Clear();
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return std::get<0>(columns_).Capacity();
+    }
+
+    void Reserve(size_t new_capacity){
+        if(new_capacity <= Capacity()){
+            return;
+        }
+
+        Columns new_columns = AllocateColumns(new_capacity);
+        RelocateColumns(new_columns);
+        columns_.swap(new_columns);
+    }
+
+    void Resize(size_t new_size){
+        if(new_size <= size_){
+            DestroyRows(new_size, size_);
+        } else {
+            Reserve(new_size);
+            // Поля строятся по столбцам. При исключении уже построенные столбцы уничтожаются
+            size_t constructed_columns = 0;
+            try {
+                ForEachField([&](auto field) {
+                    std::uninitialized_value_construct_n(Data<field>() + size_, new_size - size_);
+                    ++constructed_columns;
+                });
+            } catch(...){
+                ForEachField([&](auto field) {
+                    if(field < constructed_columns){
+                        std::destroy_n(Data<field>() + size_, new_size - size_);
+                    }
+                });
+                throw;
+            }
+        }
+        size_ = new_size;
+    }
+
+    void PushBack(const Ts&... fields){
+        EmplaceBack(fields...);
+    }
+
+    void PushBack(Ts&&... fields){
+        EmplaceBack(std::move(fields)...);
+    }
+
+    // Каждый аргумент строит одно поле новой строки
+    template <typename... Args>
+    Row EmplaceBack(Args&&... field_args){
+        static_assert(sizeof...(Args) == FIELD_COUNT, "EmplaceBack takes one argument per field");
+        if(size_ == Capacity()){
+            // Новая строка строится до переноса старых, поэтому аргументы
+            // могут ссылаться на поля этого же вектора
+            Columns new_columns = AllocateColumns(DoublingGrowth::NextCapacity(size_, RowSize()));
+            ConstructRow(new_columns, size_, Indices{}, std::forward<Args>(field_args)...);
+            try {
+                RelocateColumns(new_columns);
+            } catch(...){
+                DestroyRowFields(new_columns, size_, FIELD_COUNT);
+                throw;
+            }
+            columns_.swap(new_columns);
+        } else {
+            ConstructRow(columns_, size_, Indices{}, std::forward<Args>(field_args)...);
+        }
+        ++size_;
+        return (*this)[size_ - 1];
+    }
+
+    // Удаляет строку index, сдвигая последующие строки
+    void Erase(size_t index){
+        Erase(index, index + 1);
+    }
+
+    void Erase(size_t first, size_t last){
+        assert(first <= last && last <= size_);
+        if(first == last){
+            return;
+        }
+        ForEachField([&](auto field) {
+            std::move(Data<field>() + last, Data<field>() + size_, Data<field>() + first);
+        });
+        DestroyRows(size_ - (last - first), size_);
+        size_ -= last - first;
+    }
+
+    void PopBack() noexcept {
+        assert(size_ != 0);
+        DestroyRows(size_ - 1, size_);
+        --size_;
+    }
+
+    void Clear() noexcept {
+        DestroyRows(0, size_);
+        size_ = 0;
+    }
+
+    // Непрерывный массив из Size() значений поля I
+    template <size_t I>
+    Field<I>* Data() noexcept {
+        return std::get<I>(columns_).GetAddress();
+    }
+
+    template <size_t I>
+    const Field<I>* Data() const noexcept {
+        return std::get<I>(columns_).GetAddress();
+    }
+
+    Row operator[](size_t index) noexcept {
+        assert(index < size_);
+        return GetRow<Row>(*this, index, Indices{});
+    }
+
+    ConstRow operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return GetRow<ConstRow>(*this, index, Indices{});
+    }
+
+    void Swap(SoaVector& other) noexcept {
+        columns_.swap(other.columns_);
+        std::swap(size_, other.size_);
+    }
+
+private:
+    static constexpr size_t RowSize() noexcept {
+        return (sizeof(Ts) + ...);
+    }
+
+    // Вызывает function(std::integral_constant<size_t, I>{}) для каждого поля по порядку
+    template <typename Function>
+    static void ForEachField(Function&& function){
+        ForEachFieldImpl(function, Indices{});
+    }
+
+    template <typename Function, size_t... Is>
+    static void ForEachFieldImpl(Function& function, std::index_sequence<Is...>){
+        (function(std::integral_constant<size_t, Is>{}), ...);
+    }
+
+    template <typename Result, typename Self, size_t... Is>
+    static Result GetRow(Self& self, size_t index, std::index_sequence<Is...>) noexcept {
+        return Result(self.template Data<Is>()[index]...);
+    }
+
+    static Columns AllocateColumns(size_t capacity){
+        return Columns(RawMemory<Ts>(capacity)...);
+    }
+
+    template <typename... Args, size_t... Is>
+    static void ConstructRow(Columns& columns, size_t index, std::index_sequence<Is...>, Args&&... field_args){
+        size_t constructed = 0;
+        try {
+            ((new (std::get<Is>(columns) + index) Field<Is>(std::forward<Args>(field_args)), ++constructed), ...);
+        } catch(...){
+            DestroyRowFields(columns, index, constructed);
+            throw;
+        }
+    }
+
+    // Уничтожает первые count полей строки index
+    static void DestroyRowFields(Columns& columns, size_t index, size_t count) noexcept {
+        ForEachField([&](auto field) {
+            if(field < count){
+                std::destroy_at(std::get<field>(columns) + index);
+            }
+        });
+    }
+
+    void DestroyRows(size_t first, size_t last) noexcept {
+        ForEachField([&](auto field) {
+            std::destroy_n(Data<field>() + first, last - first);
+        });
+    }
+
+    // Переносит строки в new_columns и уничтожает старые. Сначала копируются поля,
+    // копирование которых может бросить исключение: пока старые данные не тронуты,
+    // откат сводится к уничтожению копий. Остальные поля переносятся без исключений
+    void RelocateColumns(Columns& new_columns){
+        size_t copied_columns = 0;
+        try {
+            ForEachField([&](auto field) {
+                if constexpr(MAY_THROW_ON_RELOCATE<field>){
+                    UninitializedRelocateN(Data<field>(), size_, std::get<field>(new_columns).GetAddress());
+                    ++copied_columns;
+                }
+            });
+        } catch(...){
+            size_t column = 0;
+            ForEachField([&](auto field) {
+                if constexpr(MAY_THROW_ON_RELOCATE<field>){
+                    if(column++ < copied_columns){
+                        std::destroy_n(std::get<field>(new_columns).GetAddress(), size_);
+                    }
+                }
+            });
+            throw;
+        }
+        ForEachField([&](auto field) {
+            if constexpr(!MAY_THROW_ON_RELOCATE<field>){
+                UninitializedRelocateN(Data<field>(), size_, std::get<field>(new_columns).GetAddress());
+            }
+            DestroyRelocatedN(Data<field>(), size_);
+        });
+    }
+
+    Columns columns_;
+    size_t size_ = 0;
+};
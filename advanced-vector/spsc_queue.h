@@ -0,0 +1,181 @@
+#pragma once
+#include "aligned_allocator.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Ограниченная очередь без блокировок для одного потока-производителя и одного
+// потока-потребителя. Try*-методы добавления вызывает только производитель,
+// методы извлечения - только потребитель.
+// Индексы head_ и tail_ растут неограниченно и отображаются на буфер маской.
+// Каждый индекс лежит в отдельной строке кэша вместе с копией индекса другой стороны:
+// производитель перечитывает head_ только тогда, когда по своей копии видит
+// очередь заполненной, а потребитель перечитывает tail_, только когда видит её пустой
+template <typename T>
+class SpscQueue {
+public:
+    using value_type = T;
+
+    // Вместимость округляется вверх до степени двойки
+    explicit SpscQueue(size_t capacity)
+    : buffer_(RoundUpToPowerOfTwo(capacity))
+    , mask_(buffer_.Capacity() - 1){
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    ~SpscQueue(){
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        for(size_t head = head_.load(std::memory_order_relaxed); head != tail; ++head){
+            std::destroy_at(Slot(head));
+        }
+    }
+
+    size_t Capacity() const noexcept {
+        return buffer_.Capacity();
+    }
+
+    // Приблизительное число элементов: другая сторона может менять его одновременно
+    size_t Size() const noexcept {
+        const size_t head = head_.load(std::memory_order_acquire);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    bool IsEmpty() const noexcept {
+        return Size() == 0;
+    }
+
+    bool TryPush(const T& value){
+        return TryEmplace(value);
+    }
+
+    bool TryPush(T&& value){
+        return TryEmplace(std::move(value));
+    }
+
+    // Возвращает false, если очередь заполнена. Если конструктор бросил
+    // исключение, элемент не добавляется
+    template <typename... Args>
+    bool TryEmplace(Args&&... ctor_args){
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if(FreeSlots(tail, 1) == 0){
+            return false;
+        }
+        new (Slot(tail)) T(std::forward<Args>(ctor_args)...);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Копирует в очередь до count элементов из [first, first + count) и
+    // публикует их одной записью tail_. Возвращает число добавленных элементов.
+    // Если копирование бросило исключение, ни один элемент пакета не добавляется
+    template <typename InputIt>
+    size_t TryPushN(InputIt first, size_t count){
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        count = FreeSlots(tail, count);
+        size_t i = 0;
+        try {
+            for(; i < count; ++i, ++first){
+                new (Slot(tail + i)) T(*first);
+            }
+        } catch(...){
+            for(size_t j = 0; j < i; ++j){
+                std::destroy_at(Slot(tail + j));
+            }
+            throw;
+        }
+        tail_.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // Перемещает первый элемент в value. Возвращает false, если очередь пуста
+    bool TryPop(T& value){
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if(ReadySlots(head, 1) == 0){
+            return false;
+        }
+        T* const elem = Slot(head);
+        value = std::move(*elem);
+        std::destroy_at(elem);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Перемещает до max_count элементов в out и освобождает их одной записью head_.
+    // Для тривиально копируемых типов элементы копируются не более чем двумя memcpy.
+    // Если присваивание бросило исключение, уже извлечённые элементы остаются извлечёнными
+    template <typename OutputIt>
+    size_t TryPopN(OutputIt out, size_t max_count){
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t count = ReadySlots(head, max_count);
+        if constexpr(std::is_trivially_copyable_v<T> && std::is_pointer_v<OutputIt>
+                     && std::is_same_v<std::remove_cv_t<std::remove_pointer_t<OutputIt>>, T>){
+            const size_t first_part = std::min(count, Capacity() - (head & mask_));
+            std::copy_n(Slot(head), first_part, out);
+            std::copy_n(buffer_.GetAddress(), count - first_part, out + first_part);
+        } else {
+            size_t i = 0;
+            try {
+                for(; i < count; ++i, ++out){
+                    T* const elem = Slot(head + i);
+                    *out = std::move(*elem);
+                    std::destroy_at(elem);
+                }
+            } catch(...){
+                head_.store(head + i, std::memory_order_release);
+                throw;
+            }
+        }
+        head_.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+private:
+    static size_t RoundUpToPowerOfTwo(size_t capacity) noexcept {
+        size_t result = 1;
+        while(result < capacity){
+            result *= 2;
+        }
+        return result;
+    }
+
+    T* Slot(size_t index) noexcept {
+        return buffer_ + (index & mask_);
+    }
+
+    // Сколько из wanted ячеек свободно для производителя при его индексе tail
+    size_t FreeSlots(size_t tail, size_t wanted) noexcept {
+        if(Capacity() - (tail - cached_head_) < wanted){
+            cached_head_ = head_.load(std::memory_order_acquire);
+        }
+        return std::min(wanted, Capacity() - (tail - cached_head_));
+    }
+
+    // Сколько из wanted элементов готово для потребителя при его индексе head
+    size_t ReadySlots(size_t head, size_t wanted) noexcept {
+        if(cached_tail_ - head < wanted){
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+        }
+        return std::min(wanted, cached_tail_ - head);
+    }
+
+    // Неизменяемые после построения поля, которые читают обе стороны
+    RawMemory<T, AlignedAllocator<T>> buffer_;
+    size_t mask_;
+
+    // Строка кэша потребителя
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_ = 0;
+    size_t cached_tail_ = 0;
+
+    // Строка кэша производителя
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_ = 0;
+    size_t cached_head_ = 0;
+};
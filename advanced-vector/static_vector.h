@@ -0,0 +1,317 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace detail {
+
+// Хранилище StaticVector. Для тривиальных типов это обычный массив:
+// такой StaticVector - литеральный тип, и его можно заполнить в constexpr-функции
+// уже в C++17 и сохранить в constexpr-переменной
+template <typename T, size_t N, bool = std::is_trivial_v<T>>
+class StaticStorage {
+protected:
+    constexpr T* Data() noexcept {
+        return data_;
+    }
+
+    constexpr const T* Data() const noexcept {
+        return data_;
+    }
+
+    template <typename... Args>
+    constexpr T& Construct(size_t index, Args&&... ctor_args){
+        if constexpr(std::is_constructible_v<T, Args...>){
+            data_[index] = T(std::forward<Args>(ctor_args)...);
+        } else {
+            data_[index] = T{std::forward<Args>(ctor_args)...};
+        }
+        return data_[index];
+    }
+
+    constexpr void Destroy(size_t /*first*/, size_t /*last*/) noexcept {}
+
+    T data_[N] = {};
+    size_t size_ = 0;
+};
+
+// Для остальных типов элементы строятся в неинициализированном буфере
+template <typename T, size_t N>
+class StaticStorage<T, N, false> {
+public:
+    StaticStorage() noexcept {}
+
+    // Деструктор недостроенного объекта не вызывается, поэтому уже построенные
+    // элементы уничтожаются здесь
+    StaticStorage(const StaticStorage& other){
+        try {
+            for(; size_ < other.size_; ++size_){
+                Construct(size_, other.Data()[size_]);
+            }
+        } catch(...){
+            Destroy(0, size_);
+            throw;
+        }
+    }
+
+    StaticStorage(StaticStorage&& other) noexcept(std::is_nothrow_move_constructible_v<T>){
+        try {
+            for(; size_ < other.size_; ++size_){
+                Construct(size_, std::move(other.Data()[size_]));
+            }
+        } catch(...){
+            Destroy(0, size_);
+            throw;
+        }
+    }
+
+    StaticStorage& operator=(const StaticStorage& rhs){
+        if(this != &rhs){
+            Assign(rhs.Data(), rhs.size_);
+        }
+        return *this;
+    }
+
+    StaticStorage& operator=(StaticStorage&& rhs) noexcept(std::is_nothrow_move_assignable_v<T>
+                                                           && std::is_nothrow_move_constructible_v<T>){
+        if(this != &rhs){
+            Assign(std::make_move_iterator(rhs.Data()), rhs.size_);
+        }
+        return *this;
+    }
+
+    ~StaticStorage(){
+        Destroy(0, size_);
+    }
+
+protected:
+    T* Data() noexcept {
+        return std::launder(reinterpret_cast<T*>(buffer_));
+    }
+
+    const T* Data() const noexcept {
+        return std::launder(reinterpret_cast<const T*>(buffer_));
+    }
+
+    template <typename... Args>
+    T& Construct(size_t index, Args&&... ctor_args){
+        return *new (buffer_ + index * sizeof(T)) T(std::forward<Args>(ctor_args)...);
+    }
+
+    void Destroy(size_t first, size_t last) noexcept {
+        std::destroy(Data() + first, Data() + last);
+    }
+
+    alignas(T) unsigned char buffer_[N * sizeof(T)];
+    size_t size_ = 0;
+
+private:
+    // Присваивает общую часть, достраивает или уничтожает остаток
+    template <typename InputIt>
+    void Assign(InputIt first, size_t count){
+        size_t i = 0;
+        for(; i < count && i < size_; ++i, ++first){
+            Data()[i] = *first;
+        }
+        for(; size_ < count; ++size_, ++first){
+            Construct(size_, *first);
+        }
+        Destroy(count, size_);
+        size_ = std::min(size_, count);
+    }
+};
+
+}  // namespace detail
+
+// Вектор с фиксированной вместимостью N, хранящий элементы внутри объекта
+// и никогда не обращающийся к куче. Интерфейс повторяет Vector; добавление
+// сверх N бросает std::length_error. Для тривиальных типов все методы constexpr,
+// поэтому таблицу можно построить во время компиляции:
+//     constexpr auto TABLE = [] { StaticVector<int, 16> t; ...; return t; }();
+template <typename T, size_t N>
+class StaticVector : private detail::StaticStorage<T, N> {
+    static_assert(N > 0, "StaticVector capacity must be positive");
+    using Storage = detail::StaticStorage<T, N>;
+    using Storage::Construct;
+    using Storage::Data;
+    using Storage::Destroy;
+    using Storage::size_;
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    constexpr StaticVector() noexcept = default;
+
+    constexpr explicit StaticVector(size_t size){
+        Resize(size);
+    }
+
+    constexpr StaticVector(std::initializer_list<T> list){
+        CheckCapacity(list.size());
+        for(const T& value : list){
+            EmplaceBack(value);
+        }
+    }
+
+    static constexpr size_t Capacity() noexcept {
+        return N;
+    }
+
+    constexpr size_t Size() const noexcept {
+        return size_;
+    }
+
+    // Вместимость фиксирована: Reserve только проверяет, что capacity не больше N
+    constexpr void Reserve(size_t capacity) const {
+        CheckCapacity(capacity);
+    }
+
+    constexpr void Resize(size_t new_size){
+        CheckCapacity(new_size);
+        if(new_size <= size_){
+            Destroy(new_size, size_);
+            size_ = new_size;
+        } else {
+            while(size_ < new_size){
+                EmplaceBack();
+            }
+        }
+    }
+
+    constexpr void Clear() noexcept {
+        Destroy(0, size_);
+        size_ = 0;
+    }
+
+    constexpr void PushBack(const T& value){
+        EmplaceBack(value);
+    }
+
+    constexpr void PushBack(T&& value){
+        EmplaceBack(std::move(value));
+    }
+
+    template <typename... Args>
+    constexpr T& EmplaceBack(Args&&... ctor_args){
+        CheckCapacity(size_ + 1);
+        T& elem = Construct(size_, std::forward<Args>(ctor_args)...);
+        ++size_;
+        return elem;
+    }
+
+    constexpr iterator Insert(const_iterator pos, const T& value){
+        return Emplace(pos, value);
+    }
+
+    constexpr iterator Insert(const_iterator pos, T&& value){
+        return Emplace(pos, std::move(value));
+    }
+
+    template <typename... Args>
+    constexpr iterator Emplace(const_iterator pos, Args&&... ctor_args){
+        const size_t index = pos - begin();
+        assert(index <= size_);
+        CheckCapacity(size_ + 1);
+        if(index == size_){
+            EmplaceBack(std::forward<Args>(ctor_args)...);
+            return begin() + index;
+        }
+        // Аргументы могут ссылаться на элементы, которые сдвинутся
+        T elem(std::forward<Args>(ctor_args)...);
+        Construct(size_, std::move(Data()[size_ - 1]));
+        ++size_;
+        for(size_t i = size_ - 2; i > index; --i){
+            Data()[i] = std::move(Data()[i - 1]);
+        }
+        Data()[index] = std::move(elem);
+        return begin() + index;
+    }
+
+    constexpr iterator Erase(const_iterator pos){
+        return Erase(pos, pos + 1);
+    }
+
+    constexpr iterator Erase(const_iterator first, const_iterator last){
+        const size_t index = first - begin();
+        const size_t count = last - first;
+        assert(index + count <= size_);
+        for(size_t i = index; i + count < size_; ++i){
+            Data()[i] = std::move(Data()[i + count]);
+        }
+        Destroy(size_ - count, size_);
+        size_ -= count;
+        return begin() + index;
+    }
+
+    constexpr void PopBack() noexcept {
+        assert(size_ != 0);
+        Destroy(size_ - 1, size_);
+        --size_;
+    }
+
+    constexpr const T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    constexpr T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    constexpr iterator begin() noexcept {
+        return Data();
+    }
+
+    constexpr iterator end() noexcept {
+        return Data() + size_;
+    }
+
+    constexpr const_iterator begin() const noexcept {
+        return Data();
+    }
+
+    constexpr const_iterator end() const noexcept {
+        return Data() + size_;
+    }
+
+    constexpr const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    constexpr const_iterator cend() const noexcept {
+        return end();
+    }
+
+    // Элементы хранятся внутри объектов, поэтому обмен занимает O(N)
+    constexpr void Swap(StaticVector& other){
+        StaticVector& longer = size_ >= other.size_ ? *this : other;
+        StaticVector& shorter = size_ >= other.size_ ? other : *this;
+        for(size_t i = 0; i < shorter.size_; ++i){
+            T tmp(std::move(longer.Data()[i]));
+            longer.Data()[i] = std::move(shorter.Data()[i]);
+            shorter.Data()[i] = std::move(tmp);
+        }
+        const size_t common = shorter.size_;
+        for(; shorter.size_ < longer.size_; ++shorter.size_){
+            shorter.Construct(shorter.size_, std::move(longer.Data()[shorter.size_]));
+        }
+        longer.Destroy(common, longer.size_);
+        longer.size_ = common;
+    }
+
+private:
+    static constexpr void CheckCapacity(size_t size){
+        if(size > N){
+            throw std::length_error("StaticVector capacity exceeded");
+        }
+    }
+};
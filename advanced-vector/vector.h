@@ -2,134 +2,500 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iterator>
 #include <new>
 #include <memory>
+#include <type_traits>
 
 #include <iostream>
 
+// Начиная с C++20 Vector можно использовать при вычислениях во время компиляции:
+// там разрешены выделение памяти через std::allocator и std::construct_at.
+// В C++17 VECTOR_CONSTEXPR раскрывается в пустую строку
+#if defined(__cpp_constexpr_dynamic_alloc) && defined(__cpp_lib_constexpr_dynamic_alloc) \
+    && defined(__cpp_lib_is_constant_evaluated)
+#define VECTOR_HAS_CONSTEXPR_ALLOCATION 1
+#define VECTOR_CONSTEXPR constexpr
+#else
+#define VECTOR_HAS_CONSTEXPR_ALLOCATION 0
+#define VECTOR_CONSTEXPR
+#endif
+
+namespace detail {
+
+constexpr bool IsConstantEvaluated() noexcept {
+#if VECTOR_HAS_CONSTEXPR_ALLOCATION
+    return std::is_constant_evaluated();
+#else
+    return false;
+#endif
+}
+
+// Размещающий new, допустимый во время компиляции
+template<typename T, typename... Args>
+VECTOR_CONSTEXPR T* ConstructAt(T* location, Args&&... args){
+#if VECTOR_HAS_CONSTEXPR_ALLOCATION
+    return std::construct_at(location, std::forward<Args>(args)...);
+#else
+    return new (static_cast<void*>(location)) T(std::forward<Args>(args)...);
+#endif
+}
+
+// Аналоги std::uninitialized_*_n, которые во время компиляции строят элементы
+// по одному: исключение там всё равно прерывает вычисление
+template<typename InputIt, typename T>
+VECTOR_CONSTEXPR void UninitializedCopyN(InputIt first, size_t count, T* to){
+    if(!IsConstantEvaluated()){
+        std::uninitialized_copy_n(first, count, to);
+        return;
+    }
+    for(size_t i = 0; i < count; ++i, ++first){
+        ConstructAt(to + i, *first);
+    }
+}
+
+template<typename T>
+VECTOR_CONSTEXPR void UninitializedMoveN(T* from, size_t count, T* to){
+    UninitializedCopyN(std::make_move_iterator(from), count, to);
+}
+
+template<typename T>
+VECTOR_CONSTEXPR void UninitializedValueConstructN(T* to, size_t count){
+    if(!IsConstantEvaluated()){
+        std::uninitialized_value_construct_n(to, count);
+        return;
+    }
+    for(size_t i = 0; i < count; ++i){
+        ConstructAt(to + i);
+    }
+}
+
+}  // namespace detail
+
+// Тип можно перемещать в новую память побайтовым копированием, не вызывая
+// конструктор перемещения и деструктор исходного объекта.
+// Пользовательские типы могут явно специализировать этот шаблон
+template<typename T>
+struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+template<typename T>
+struct is_trivially_relocatable<std::unique_ptr<T>> : std::true_type {};
 
 template<typename T>
-class RawMemory{
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+// Переносит count элементов в неинициализированную память to: побайтово для тривиально
+// перемещаемых типов, иначе перемещением (если оно не бросает исключений) или копированием.
+// При исключении память to остаётся неинициализированной, а исходные элементы - целыми
+template<typename T>
+VECTOR_CONSTEXPR void UninitializedRelocateN(T* from, size_t count, T* to){
+    if constexpr(is_trivially_relocatable_v<T>){
+        // Во время компиляции побайтовое копирование недоступно
+        if(!detail::IsConstantEvaluated()){
+            if(count != 0){
+                std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), count * sizeof(T));
+            }
+            return;
+        }
+    }
+    if constexpr(std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>){
+        detail::UninitializedMoveN(from, count, to);
+    } else {
+        detail::UninitializedCopyN(from, count, to);
+    }
+}
+
+// Завершает перенос: уничтожает исходные элементы, если они не были перенесены побайтово
+template<typename T>
+VECTOR_CONSTEXPR void DestroyRelocatedN(T* from, size_t count) noexcept{
+    if(!is_trivially_relocatable_v<T> || detail::IsConstantEvaluated()){
+        std::destroy_n(from, count);
+    }
+}
+
+template<typename It>
+using IteratorCategory = typename std::iterator_traits<It>::iterator_category;
+
+// Исключает шаблонные перегрузки для итераторов из разрешения перегрузки,
+// если аргумент не является итератором (например, Vector(size_t, ...))
+template<typename It>
+using RequireInputIterator = std::enable_if_t<std::is_convertible_v<IteratorCategory<It>, std::input_iterator_tag>>;
+
+template<typename It>
+inline constexpr bool is_forward_iterator_v = std::is_convertible_v<IteratorCategory<It>, std::forward_iterator_tag>;
+
+// Политика выполнения для перегрузок Vector, распределяющих работу по потокам.
+// Политика предоставляет For(count, body) и UninitializedFor(count, construct, destroy),
+// где body, construct и destroy принимают диапазон индексов [begin, end).
+// Реализация - ParallelPolicy из parallel.h
+template<typename Policy>
+struct is_execution_policy : std::false_type {};
+
+template<typename Policy>
+inline constexpr bool is_execution_policy_v = is_execution_policy<Policy>::value;
+
+template<typename Policy>
+using RequireExecutionPolicy = std::enable_if_t<is_execution_policy_v<Policy>>;
+
+// Аллокатор хранится как базовый класс, чтобы для аллокаторов без состояния
+// (например, std::allocator) RawMemory по-прежнему занимал два машинных слова
+template<typename T, typename Allocator = std::allocator<T>>
+class RawMemory : private Allocator {
+    using AllocTraits = std::allocator_traits<Allocator>;
+
+    static_assert(std::is_same_v<typename AllocTraits::value_type, T>,
+                  "Allocator::value_type must be the same as T");
+    static_assert(std::is_same_v<typename AllocTraits::pointer, T*>,
+                  "Fancy pointers are not supported");
 public:
+    using allocator_type = Allocator;
+
     RawMemory() = default;
 
-    explicit RawMemory(size_t capacity)
-        : buffer_(Allocate(capacity))
+    VECTOR_CONSTEXPR explicit RawMemory(const Allocator& alloc) noexcept
+        : Allocator(alloc){}
+
+    VECTOR_CONSTEXPR explicit RawMemory(size_t capacity, const Allocator& alloc = Allocator())
+        : Allocator(alloc)
+        , buffer_(Allocate(capacity))
         , capacity_(capacity){}
 
     RawMemory(const RawMemory&) = delete;
     RawMemory& operator=(const RawMemory&) = delete;
 
-    RawMemory(RawMemory&& other) noexcept
-    : buffer_(other.buffer_)
+    VECTOR_CONSTEXPR RawMemory(RawMemory&& other) noexcept
+    : Allocator(std::move(other.AllocatorRef()))
+    , buffer_(other.buffer_)
     , capacity_(other.capacity_){
         other.buffer_ = nullptr;
         other.capacity_ = 0;
     }
 
-    RawMemory& operator=(RawMemory&& rhs) noexcept{
+    // Перемещающее присваивание забирает у rhs и буфер, и аллокатор.
+    // Решение о том, допустимо ли это, принимает владелец (Vector)
+    VECTOR_CONSTEXPR RawMemory& operator=(RawMemory&& rhs) noexcept{
         if(this != &rhs){
-            Deallocate(buffer_);
+            Deallocate(buffer_, capacity_);
             buffer_ = nullptr;
             capacity_ = 0;
-            Swap(rhs);
+            AllocatorRef() = std::move(rhs.AllocatorRef());
+            std::swap(buffer_, rhs.buffer_);
+            std::swap(capacity_, rhs.capacity_);
         }
         return *this;
     }
 
 
-    ~RawMemory(){
+    VECTOR_CONSTEXPR ~RawMemory(){
         if(buffer_ != nullptr){
-            Deallocate(buffer_);
+            Deallocate(buffer_, capacity_);
         }
     }
 
-    T* operator+(size_t offset) noexcept {
+    VECTOR_CONSTEXPR T* operator+(size_t offset) noexcept {
         // Разрешается получать адрес ячейки памяти, следующей за последним элементом массива
         assert(offset <= capacity_);
         return buffer_ + offset;
     }
 
-    const T* operator+(size_t offset) const noexcept {
+    VECTOR_CONSTEXPR const T* operator+(size_t offset) const noexcept {
         return const_cast<RawMemory&>(*this) + offset;
     }
 
-    const T& operator[](size_t index) const noexcept {
+    VECTOR_CONSTEXPR const T& operator[](size_t index) const noexcept {
         return const_cast<RawMemory&>(*this)[index];
     }
 
-    T& operator[](size_t index) noexcept {
+    VECTOR_CONSTEXPR T& operator[](size_t index) noexcept {
         assert(index < capacity_);
         return buffer_[index];
     }
 
-    void Swap(RawMemory& other) noexcept {
+    VECTOR_CONSTEXPR void Swap(RawMemory& other) noexcept {
+        if constexpr(AllocTraits::propagate_on_container_swap::value){
+            using std::swap;
+            swap(AllocatorRef(), other.AllocatorRef());
+        } else {
+            // Обмен буферами при различных аллокаторах без их распространения - UB
+            assert(AllocatorRef() == other.AllocatorRef());
+        }
         std::swap(buffer_, other.buffer_);
         std::swap(capacity_, other.capacity_);
     }
 
-    const T* GetAddress() const noexcept {
+    VECTOR_CONSTEXPR const T* GetAddress() const noexcept {
         return buffer_;
     }
 
-    T* GetAddress() noexcept {
+    VECTOR_CONSTEXPR T* GetAddress() noexcept {
         return buffer_;
     }
 
-    size_t Capacity() const {
+    VECTOR_CONSTEXPR size_t Capacity() const {
         return capacity_;
     }
 
-private:
-    static T* Allocate(size_t n){
-        return n != 0 ? static_cast<T*>((operator new(n * sizeof(T)))) : nullptr;
+    VECTOR_CONSTEXPR const Allocator& GetAllocator() const noexcept {
+        return *this;
     }        
 
-    static void Deallocate(T* buf) noexcept {
-        operator delete(buf);
+private:
+    VECTOR_CONSTEXPR Allocator& AllocatorRef() noexcept {
+        return *this;
+    }
+
+    VECTOR_CONSTEXPR T* Allocate(size_t n){
+        return n != 0 ? AllocTraits::allocate(AllocatorRef(), n) : nullptr;
+    }
+
+    VECTOR_CONSTEXPR void Deallocate(T* buf, size_t n) noexcept {
+        if(buf != nullptr){
+            AllocTraits::deallocate(AllocatorRef(), buf, n);
+        }
     }
 
     T* buffer_ = nullptr;
     size_t capacity_ = 0;
 };
 
-template <typename T>
-class Vector {
+// Политики роста вместимости при добавлении элемента в заполненный вектор.
+// NextCapacity получает текущую вместимость и размер элемента в байтах
+// и возвращает новую вместимость, строго большую текущей
+struct DoublingGrowth {
+    static constexpr size_t NextCapacity(size_t capacity, size_t /*element_size*/) noexcept {
+        return capacity == 0 ? 1 : capacity * 2;
+    }
+};
+
+// Рост в Num/Den раз, например GrowthFactor<3, 2> для роста в полтора раза
+template <size_t Num, size_t Den>
+struct GrowthFactor {
+    static_assert(Den != 0 && Num > Den, "Growth factor must be greater than one");
+
+    static constexpr size_t NextCapacity(size_t capacity, size_t /*element_size*/) noexcept {
+        return std::max(capacity + 1, capacity / Den * Num + capacity % Den * Num / Den);
+    }
+};
+
+// Первая аллокация сразу выделяет место под MinCapacity элементов
+template <size_t MinCapacity, typename Base = DoublingGrowth>
+struct MinCapacityGrowth {
+    static constexpr size_t NextCapacity(size_t capacity, size_t element_size) noexcept {
+        return std::max(MinCapacity, Base::NextCapacity(capacity, element_size));
+    }
+};
+
+// Округляет размер буфера в байтах вверх до классов размеров в духе jemalloc:
+// шаг 16 байт для малых размеров и четыре класса на каждый интервал между
+// степенями двойки для больших. Запрошенная у аллокатора
+// память, которую он всё равно выделил бы, не теряется впустую
+template <typename Base = GrowthFactor<3, 2>>
+struct SizeClassGrowth {
+    static size_t NextCapacity(size_t capacity, size_t element_size) noexcept {
+        const size_t min_bytes = Base::NextCapacity(capacity, element_size) * element_size;
+        return RoundUpToSizeClass(min_bytes) / element_size;
+    }
+
+    static size_t RoundUpToSizeClass(size_t bytes) noexcept {
+        constexpr size_t MIN_CLASS = 16;
+        if(bytes <= MIN_CLASS){
+            return MIN_CLASS;
+        }
+        size_t group = MIN_CLASS;
+        while(group * 2 < bytes){
+            group *= 2;
+        }
+        const size_t step = std::max(MIN_CLASS, group / 4);
+        return (bytes + step - 1) / step * step;
+    }
+};
+
+// Тег для создания элементов инициализацией по умолчанию вместо value-инициализации:
+// память под тривиальные типы не обнуляется
+struct DefaultInitTag {
+    explicit DefaultInitTag() = default;
+};
+
+inline constexpr DefaultInitTag default_init{};
+
+// Счётчики, собираемые CountingInstrumentation
+struct VectorStats {
+    size_t allocations = 0;
+    size_t bytes_allocated = 0;
+    // Реаллокации при добавлении элементов в заполненный вектор (EmplaceBack, Emplace, Insert)
+    size_t growth_reallocations = 0;
+    // Элементы, перенесённые в новый буфер перемещением, копированием и побайтово
+    size_t elements_moved = 0;
+    size_t elements_copied = 0;
+    size_t elements_relocated = 0;
+    size_t peak_capacity = 0;
+};
+
+// Политики инструментирования Vector. Политика хранится как базовый класс,
+// поэтому пустая политика по умолчанию не увеличивает размер вектора
+struct NoInstrumentation {
+    constexpr void OnAllocate(size_t /*capacity*/, size_t /*bytes*/) noexcept {}
+    constexpr void OnGrowth() noexcept {}
+    constexpr void OnMove(size_t /*count*/) noexcept {}
+    constexpr void OnCopy(size_t /*count*/) noexcept {}
+    constexpr void OnRelocate(size_t /*count*/) noexcept {}
+};
+
+class CountingInstrumentation {
 public:
+    void OnAllocate(size_t capacity, size_t bytes) noexcept {
+        if(capacity != 0){
+            ++stats_.allocations;
+            stats_.bytes_allocated += bytes;
+            stats_.peak_capacity = std::max(stats_.peak_capacity, capacity);
+        }
+    }
+
+    void OnGrowth() noexcept {
+        ++stats_.growth_reallocations;
+    }
+
+    void OnMove(size_t count) noexcept {
+        stats_.elements_moved += count;
+    }
+
+    void OnCopy(size_t count) noexcept {
+        stats_.elements_copied += count;
+    }
+
+    void OnRelocate(size_t count) noexcept {
+        stats_.elements_relocated += count;
+    }
+
+    const VectorStats& GetStats() const noexcept {
+        return stats_;
+    }
+
+    void ResetStats() noexcept {
+        stats_ = VectorStats{};
+    }
+
+private:
+    VectorStats stats_;
+};
+
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth,
+          typename Instrumentation = NoInstrumentation>
+class Vector : private Instrumentation {
+    using AllocTraits = std::allocator_traits<Allocator>;
+    using Memory = RawMemory<T, Allocator>;
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
     using iterator = T*;
     using const_iterator = const T*;
 
-    Vector() noexcept = default;
+    VECTOR_CONSTEXPR Vector() noexcept(noexcept(Allocator())) = default;
+
+    VECTOR_CONSTEXPR explicit Vector(const Allocator& alloc) noexcept
+    : data_(alloc){}
 
-    explicit Vector(size_t size)
-    : data_(size)
+    VECTOR_CONSTEXPR explicit Vector(size_t size, const Allocator& alloc = Allocator())
+    : data_(AllocateMemory(size, alloc))
     , size_(size)
     {   
-        std::uninitialized_value_construct_n(data_.GetAddress(), size_);
+        detail::UninitializedValueConstructN(data_.GetAddress(), size_);
     }
 
-    explicit Vector(std::initializer_list<T> list)
-    : data_(list.size())
+    explicit Vector(size_t size, DefaultInitTag, const Allocator& alloc = Allocator())
+    : data_(AllocateMemory(size, alloc))
+    , size_(size)
+    {
+        std::uninitialized_default_construct_n(data_.GetAddress(), size_);
+    }
+
+    VECTOR_CONSTEXPR explicit Vector(std::initializer_list<T> list, const Allocator& alloc = Allocator())
+    : data_(AllocateMemory(list.size(), alloc))
     , size_(list.size())
     {
         if constexpr(std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>){
-            std::uninitialized_move_n(list.begin(), size_, data_.GetAddress());
+            detail::UninitializedCopyN(std::make_move_iterator(list.begin()), size_, data_.GetAddress());
+        } else {
+            detail::UninitializedCopyN(list.begin(), size_, data_.GetAddress()); 
+        }
+    }
+
+    template <typename InputIt, typename = RequireInputIterator<InputIt>>
+    VECTOR_CONSTEXPR Vector(InputIt first, InputIt last, const Allocator& alloc = Allocator())
+    : data_(alloc)
+    {
+        if constexpr(is_forward_iterator_v<InputIt>){
+            const size_t count = std::distance(first, last);
+            Memory new_data = AllocateMemory(count);
+            detail::UninitializedCopyN(first, count, new_data.GetAddress());
+            data_.Swap(new_data);
+            size_ = count;
         } else {
-            std::uninitialized_copy_n(list.begin(), size_, data_.GetAddress()); 
+            for(; first != last; ++first){
+                EmplaceBack(*first);
+            }
         }
     }
 
-    explicit Vector(const Vector& other)
-    : data_(other.size_)
+    VECTOR_CONSTEXPR explicit Vector(const Vector& other)
+    : Vector(other, AllocTraits::select_on_container_copy_construction(other.data_.GetAllocator()))
+    {}
+
+    // Перегрузки с политикой выполнения строят элементы параллельно. Если
+    // построение бросает исключение, уже построенные порции уничтожаются
+    template <typename Policy, typename = RequireExecutionPolicy<Policy>>
+    Vector(size_t size, const Policy& policy, const Allocator& alloc = Allocator())
+    : data_(AllocateMemory(size, alloc))
+    , size_(size)
+    {
+        T* const data = data_.GetAddress();
+        policy.UninitializedFor(size_, [data](size_t begin, size_t end) {
+            std::uninitialized_value_construct_n(data + begin, end - begin);
+        }, [data](size_t begin, size_t end) {
+            std::destroy_n(data + begin, end - begin);
+        });
+    }
+
+    template <typename Policy, typename = RequireExecutionPolicy<Policy>>
+    Vector(const Vector& other, const Policy& policy)
+    : Vector(other, policy, AllocTraits::select_on_container_copy_construction(other.data_.GetAllocator()))
+    {}
+
+    template <typename Policy, typename = RequireExecutionPolicy<Policy>>
+    Vector(const Vector& other, const Policy& policy, const Allocator& alloc)
+    : data_(AllocateMemory(other.size_, alloc))
+    , size_(other.size_)
+    {
+        const T* const from = other.data_.GetAddress();
+        T* const to = data_.GetAddress();
+        policy.UninitializedFor(size_, [from, to](size_t begin, size_t end) {
+            std::uninitialized_copy_n(from + begin, end - begin, to + begin);
+        }, [to](size_t begin, size_t end) {
+            std::destroy_n(to + begin, end - begin);
+        });
+    }
+
+    VECTOR_CONSTEXPR Vector(const Vector& other, const Allocator& alloc)
+    : data_(AllocateMemory(other.size_, alloc))
     , size_(other.size_)
     {   
-        std::uninitialized_copy_n(other.data_.GetAddress(), size_, data_.GetAddress());
+        detail::UninitializedCopyN(other.data_.GetAddress(), size_, data_.GetAddress());
     }
 
-    Vector& operator=(const Vector& rhs){
+    VECTOR_CONSTEXPR Vector& operator=(const Vector& rhs){
         if(this != &rhs){
+            if constexpr(AllocTraits::propagate_on_container_copy_assignment::value){
+                if(data_.GetAllocator() != rhs.data_.GetAllocator()){
+                    // Память текущего аллокатора освобождается им же до смены аллокатора
+                    std::destroy_n(data_.GetAddress(), size_);
+                    size_ = 0;
+                    data_ = Memory(rhs.data_.GetAllocator());
+                }
+            }
             if(rhs.size_ > data_.Capacity()){
-                Vector rhs_copy(rhs);
+                Vector rhs_copy(rhs, data_.GetAllocator());
                 Swap(rhs_copy);
             } else {
                 if(rhs.size_ >= size_){
@@ -137,7 +503,7 @@ public:
                     for(; i < size_; ++i){
                         data_[i] = rhs[i];
                     }
-                    std::uninitialized_copy_n(rhs.data_.GetAddress() + i, rhs.size_ - size_, data_.GetAddress() + i);
+                    detail::UninitializedCopyN(rhs.data_.GetAddress() + i, rhs.size_ - size_, data_.GetAddress() + i);
                     size_ = rhs.size_;
                 } else {
                     size_t i = 0;
@@ -152,42 +518,126 @@ public:
         return *this;
     }
 
-    Vector(Vector&& other) noexcept
-    : data_(std::move(other.data_))
+    VECTOR_CONSTEXPR Vector(Vector&& other) noexcept
+    : Instrumentation(other)
+    , data_(std::move(other.data_))
     , size_(other.size_){
         other.size_ = 0;
     }
     
-    Vector& operator=(Vector&& rhs){
+    VECTOR_CONSTEXPR Vector(Vector&& other, const Allocator& alloc)
+    : data_(alloc){
+        if(alloc == other.data_.GetAllocator()){
+            data_.Swap(other.data_);
+            std::swap(size_, other.size_);
+        } else {
+            Memory new_data = AllocateMemory(other.size_, alloc);
+            detail::UninitializedMoveN(other.data_.GetAddress(), other.size_, new_data.GetAddress());
+            data_.Swap(new_data);
+            size_ = other.size_;
+        }
+    }
+
+    VECTOR_CONSTEXPR Vector& operator=(Vector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                             || AllocTraits::is_always_equal::value){
         if(this != &rhs){
-            data_ = std::move(rhs.data_);
-            size_ = rhs.size_;
-            rhs.size_ = 0;
+            if constexpr(AllocTraits::propagate_on_container_move_assignment::value
+                         || AllocTraits::is_always_equal::value){
+                StealStorage(rhs);
+            } else {
+                if(data_.GetAllocator() == rhs.data_.GetAllocator()){
+                    StealStorage(rhs);
+                } else {
+                    // Буфер rhs нельзя освободить нашим аллокатором, поэтому элементы перемещаются по одному
+                    Memory new_data = AllocateMemory(rhs.size_);
+                    detail::UninitializedMoveN(rhs.data_.GetAddress(), rhs.size_, new_data.GetAddress());
+                    std::destroy_n(data_.GetAddress(), size_);
+                    data_.Swap(new_data);
+                    size_ = rhs.size_;
+                }
+            }
         }
 
         return *this;
     }
 
-    size_t Size() const noexcept {
+    VECTOR_CONSTEXPR allocator_type GetAllocator() const noexcept {
+        return data_.GetAllocator();
+    }
+
+    const Instrumentation& GetInstrumentation() const noexcept {
+        return *this;
+    }
+
+    Instrumentation& GetInstrumentation() noexcept {
+        return *this;
+    }
+
+    VECTOR_CONSTEXPR size_t Size() const noexcept {
         return size_;
     }
 
-    size_t Capacity() const noexcept {
+    VECTOR_CONSTEXPR size_t Capacity() const noexcept {
         return data_.Capacity();
     }
 
-    void Reserve(size_t new_capacity){
+    VECTOR_CONSTEXPR void Reserve(size_t new_capacity){
         if(new_capacity <= data_.Capacity()){
             return;
         }
 
-        RawMemory<T> new_data(new_capacity);
+        Memory new_data = AllocateMemory(new_capacity);
         FillNewData(new_data, 0, 0, size_);
-        std::destroy_n(data_.GetAddress(), size_);
+        DestroyOldData();
         data_.Swap(new_data);
     }
 
-    void Resize(size_t new_size){
+    template <typename Policy, typename = RequireExecutionPolicy<Policy>>
+    void Reserve(size_t new_capacity, const Policy& policy){
+        if(new_capacity <= data_.Capacity()){
+            return;
+        }
+
+        Memory new_data = AllocateMemory(new_capacity);
+        FillNewData(new_data, size_, policy);
+        DestroyOldData(policy);
+        data_.Swap(new_data);
+    }
+
+    // Перевыделяет память ровно под Size() элементов
+    VECTOR_CONSTEXPR void ShrinkToFit(){
+        if(size_ == data_.Capacity()){
+            return;
+        }
+
+        Memory new_data = AllocateMemory(size_);
+        FillNewData(new_data, 0, 0, size_);
+        DestroyOldData();
+        data_.Swap(new_data);
+    }
+
+    // Удаляет все элементы, сохраняя вместимость
+    VECTOR_CONSTEXPR void Clear() noexcept{
+        std::destroy_n(data_.GetAddress(), size_);
+        size_ = 0;
+    }
+
+    template <typename Policy, typename = RequireExecutionPolicy<Policy>>
+    void Clear(const Policy& policy){
+        T* const data = data_.GetAddress();
+        policy.For(size_, [data](size_t begin, size_t end) {
+            std::destroy_n(data + begin, end - begin);
+        });
+        size_ = 0;
+    }
+
+    // Удаляет все элементы и освобождает память
+    VECTOR_CONSTEXPR void Release() noexcept{
+        Clear();
+        data_ = Memory(data_.GetAllocator());
+    }
+
+    VECTOR_CONSTEXPR void Resize(size_t new_size){
         if(new_size <= size_){
             size_t left_elems = size_ - new_size;
             if(left_elems != 0){
@@ -196,37 +646,123 @@ public:
             
         } else {
             Reserve(new_size);
-            std::uninitialized_value_construct_n(data_.GetAddress() + size_, new_size - size_);
+            detail::UninitializedValueConstructN(data_.GetAddress() + size_, new_size - size_);
         }
         size_ = new_size;
     }
 
-    void PushBack(const T& value){
+    template <typename Policy, typename = RequireExecutionPolicy<Policy>>
+    void Resize(size_t new_size, const Policy& policy){
+        T* const data = data_.GetAddress();
+        if(new_size <= size_){
+            policy.For(size_ - new_size, [data, new_size](size_t begin, size_t end) {
+                std::destroy_n(data + new_size + begin, end - begin);
+            });
+        } else {
+            Reserve(new_size, policy);
+            T* const tail = data_.GetAddress() + size_;
+            policy.UninitializedFor(new_size - size_, [tail](size_t begin, size_t end) {
+                std::uninitialized_value_construct_n(tail + begin, end - begin);
+            }, [tail](size_t begin, size_t end) {
+                std::destroy_n(tail + begin, end - begin);
+            });
+        }
+        size_ = new_size;
+    }
+
+    // Аналог Resize, не обнуляющий новые элементы тривиальных типов
+    void ResizeDefaultInit(size_t new_size){
+        if(new_size <= size_){
+            std::destroy_n(data_.GetAddress() + new_size, size_ - new_size);
+        } else {
+            Reserve(new_size);
+            std::uninitialized_default_construct_n(data_.GetAddress() + size_, new_size - size_);
+        }
+        size_ = new_size;
+    }
+
+    // По аналогии с std::string::resize_and_overwrite: увеличивает размер до count
+    // без обнуления, вызывает op(data, count) и оставляет первые op(...) элементов.
+    // Если op бросает исключение, размер вектора не меняется
+    template <typename Operation>
+    void ResizeAndOverwrite(size_t count, Operation op){
+        const size_t old_size = size_;
+        if(count > old_size){
+            Reserve(count);
+            std::uninitialized_default_construct_n(data_.GetAddress() + old_size, count - old_size);
+        }
+        const size_t constructed = std::max(count, old_size);
+        size_t new_size = 0;
+        try {
+            new_size = static_cast<size_t>(op(data_.GetAddress(), count));
+        } catch(...){
+            std::destroy_n(data_.GetAddress() + old_size, constructed - old_size);
+            throw;
+        }
+        assert(new_size <= count);
+        std::destroy_n(data_.GetAddress() + new_size, constructed - new_size);
+        size_ = new_size;
+    }
+
+    VECTOR_CONSTEXPR void PushBack(const T& value){
         EmplaceBack(value);
     }   
 
-    void PushBack(T&& value){
+    VECTOR_CONSTEXPR void PushBack(T&& value){
         EmplaceBack(std::move(value));
     }
 
-    iterator Insert(const_iterator pos, const T& value){
+    VECTOR_CONSTEXPR iterator Insert(const_iterator pos, const T& value){
         return Emplace(pos, value);
     }
 
-    iterator Insert(const_iterator pos, T&& value){
+    VECTOR_CONSTEXPR iterator Insert(const_iterator pos, T&& value){
         return Emplace(pos, std::move(value));
     }
 
+    // Вставляет count копий value, сдвигая хвост и перевыделяя память не более одного раза
+    iterator Insert(const_iterator pos, size_t count, const T& value){
+        const size_t index = pos - begin();
+        if(count != 0){
+            // value может ссылаться на элемент самого вектора
+            const T value_copy(value);
+            InsertRange(index, RepeatIterator(value_copy), count);
+        }
+        return begin() + index;
+    }
+
+    // Вставляет диапазон [first, last), не принадлежащий самому вектору
+    template <typename InputIt, typename = RequireInputIterator<InputIt>>
+    iterator Insert(const_iterator pos, InputIt first, InputIt last){
+        const size_t index = pos - begin();
+        if constexpr(is_forward_iterator_v<InputIt>){
+            InsertRange(index, first, std::distance(first, last));
+        } else {
+            // Длину однопроходного диапазона нельзя узнать заранее, поэтому он сначала
+            // собирается во временный вектор
+            Vector buffer(first, last, data_.GetAllocator());
+            InsertRange(index, std::make_move_iterator(buffer.begin()), buffer.size_);
+        }
+        return begin() + index;
+    }
+
+    template <typename Range>
+    void Append(const Range& range){
+        Insert(cend(), std::begin(range), std::end(range));
+    }
+
     template <typename... Args>
-    T& EmplaceBack(Args&&... ctor_args){
+    VECTOR_CONSTEXPR T& EmplaceBack(Args&&... ctor_args){
         if(size_ == data_.Capacity()){
-            RawMemory<T> new_data((size_ == 0 ? 1 : size_ * 2));
-            FillNewData(new_data,0,  0, size_);
-            new (new_data.GetAddress() + size_) T(std::forward<Args>(ctor_args)...);
-            std::destroy_n(data_.GetAddress(), size_);
+            Instrumentation::OnGrowth();
+            Memory new_data = AllocateMemory(NextCapacity());
+            // Новый элемент создаётся до переноса старых, так как аргументы могут ссылаться на них
+            detail::ConstructAt(new_data.GetAddress() + size_, std::forward<Args>(ctor_args)...);
+            FillBehindIndex(new_data, size_);
+            DestroyOldData();
             data_.Swap(new_data);
         } else {
-            new (data_.GetAddress() + size_) T(std::forward<Args>(ctor_args)...);
+            detail::ConstructAt(data_.GetAddress() + size_, std::forward<Args>(ctor_args)...);
         }
         ++size_; 
 
@@ -234,25 +770,28 @@ public:
     }
 
     template <typename... Args>
-    iterator Emplace(const_iterator pos, Args&&... ctor_args){
+    VECTOR_CONSTEXPR iterator Emplace(const_iterator pos, Args&&... ctor_args){
         size_t index = pos - data_.GetAddress();
 
         if(size_ == data_.Capacity()){
-            RawMemory<T> new_data((size_ == 0 ? 1 : size_ * 2));
-            new (new_data + index) T(std::forward<Args>(ctor_args)...);
+            Instrumentation::OnGrowth();
+            Memory new_data = AllocateMemory(NextCapacity());
+            detail::ConstructAt(new_data + index, std::forward<Args>(ctor_args)...);
             FillBehindIndex(new_data,index);
             FillAfterIndex(new_data,index);
-            std::destroy_n(data_.GetAddress(), size_);
+            DestroyOldData();
             data_.Swap(new_data);
         } else {
             
-            if(size_ != 0){
+            if(index == size_){
+                detail::ConstructAt(end(), std::forward<Args>(ctor_args)...);
+            } else if constexpr(IsSingleValue<Args...>() && std::is_nothrow_move_assignable_v<T>){
+                InsertValue(index, std::forward<Args>(ctor_args)...);
+            } else {
+                // Аргументы могут ссылаться на элементы, которые сдвинутся
                 T elem(std::forward<Args>(ctor_args)...);
-                new (end()) T(std::move(data_[size_ - 1]));
-                std::move_backward(begin() + index, end() - 1, end());
+                ShiftRight(index);
                 data_[index] = std::move(elem);
-            } else {
-                new (data_.GetAddress()) T(std::forward<Args>(ctor_args)...);
             }
             
         }
@@ -260,7 +799,7 @@ public:
         return begin() + index;
     }
 
-    iterator Erase(const_iterator pos){
+    VECTOR_CONSTEXPR iterator Erase(const_iterator pos){
         size_t index = pos - data_.GetAddress();
         std::move(begin() + index + 1, end(), begin() + index);
         data_[size_ - 1].~T();
@@ -268,81 +807,336 @@ public:
         return begin() + index;
     }
 
-    void PopBack() noexcept{
+    // Удаляет диапазон [first, last), сдвигая хвост один раз
+    VECTOR_CONSTEXPR iterator Erase(const_iterator first, const_iterator last){
+        const size_t index = first - data_.GetAddress();
+        const size_t count = last - first;
+        assert(index + count <= size_);
+        if(count == 0){
+            return begin() + index;
+        }
+
+        T* const pos = begin() + index;
+        if constexpr(is_trivially_relocatable_v<T>){
+            if(!detail::IsConstantEvaluated()){
+                std::destroy_n(pos, count);
+                std::memmove(static_cast<void*>(pos), static_cast<const void*>(pos + count),
+                             (size_ - index - count) * sizeof(T));
+                size_ -= count;
+                return pos;
+            }
+        }
+        std::move(pos + count, end(), pos);
+        std::destroy_n(end() - count, count);
+        size_ -= count;
+        return pos;
+    }
+
+    // Удаляет элемент за O(1), перемещая на его место последний элемент.
+    // Порядок остальных элементов не сохраняется
+    VECTOR_CONSTEXPR iterator SwapErase(const_iterator pos){
+        const size_t index = pos - data_.GetAddress();
+        assert(index < size_);
+        if(index != size_ - 1){
+            data_[index] = std::move(data_[size_ - 1]);
+        }
+        PopBack();
+        return begin() + index;
+    }
+
+    VECTOR_CONSTEXPR void PopBack() noexcept{
         std::destroy_at(data_.GetAddress() + size_ - 1);
         --size_;
     }
 
-    const T& operator[](size_t index) const noexcept {
+    VECTOR_CONSTEXPR const T& operator[](size_t index) const noexcept {
         return const_cast<Vector&>(*this)[index];
     }
 
-    T& operator[](size_t index) noexcept {
+    VECTOR_CONSTEXPR T& operator[](size_t index) noexcept {
         assert(index < size_);
         return data_[index];
     }
 
-    iterator begin() noexcept{
+    VECTOR_CONSTEXPR iterator begin() noexcept{
         return data_.GetAddress();
     }
 
-    iterator end() noexcept{
+    VECTOR_CONSTEXPR iterator end() noexcept{
         return data_.GetAddress() + size_;
     }
 
-    const_iterator begin() const noexcept{
+    VECTOR_CONSTEXPR const_iterator begin() const noexcept{
         return data_.GetAddress();
     }
 
-    const_iterator end() const noexcept{
+    VECTOR_CONSTEXPR const_iterator end() const noexcept{
         return data_.GetAddress() + size_;
     }
 
-    const_iterator cbegin() const noexcept{
+    VECTOR_CONSTEXPR const_iterator cbegin() const noexcept{
         return data_.GetAddress();
     }
 
-    const_iterator cend() const noexcept{
+    VECTOR_CONSTEXPR const_iterator cend() const noexcept{
         return data_.GetAddress() + size_;
     }
  
-    void Swap(Vector& other) noexcept{
+    VECTOR_CONSTEXPR void Swap(Vector& other) noexcept{
         data_.Swap(other.data_);
         std::swap(size_, other.size_);
     }
 
-    ~Vector(){
+    VECTOR_CONSTEXPR ~Vector(){
         if(data_.GetAddress() != nullptr){
             std::destroy_n(data_.GetAddress(), size_);
         }
     }
 private:
-    void FillNewData(RawMemory<T>& new_data, size_t from, size_t to, size_t count){
-        if constexpr(std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>){
-            std::uninitialized_move_n(data_.GetAddress() + from, count, new_data.GetAddress() + to);
+    VECTOR_CONSTEXPR size_t NextCapacity() const noexcept{
+        const size_t new_capacity = GrowthPolicy::NextCapacity(data_.Capacity(), sizeof(T));
+        assert(new_capacity > size_);
+        return new_capacity;
+    }
+
+    VECTOR_CONSTEXPR Memory AllocateMemory(size_t capacity, const Allocator& alloc){
+        Instrumentation::OnAllocate(capacity, capacity * sizeof(T));
+        return Memory(capacity, alloc);
+    }
+
+    VECTOR_CONSTEXPR Memory AllocateMemory(size_t capacity){
+        return AllocateMemory(capacity, data_.GetAllocator());
+    }
+
+    // Забирает буфер вместе с аллокатором; допустимо, только если аллокаторы
+    // распространяются при перемещении или равны
+    VECTOR_CONSTEXPR void StealStorage(Vector& rhs) noexcept{
+        std::destroy_n(data_.GetAddress(), size_);
+        data_ = std::move(rhs.data_);
+        size_ = rhs.size_;
+        rhs.size_ = 0;
+    }
+
+    // Итератор, бесконечно повторяющий одно значение, для вставки count копий
+    class RepeatIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        explicit RepeatIterator(const T& value) noexcept
+        : value_(&value){}
+
+        reference operator*() const noexcept{
+            return *value_;
+        }
+
+        RepeatIterator& operator++() noexcept{
+            return *this;
+        }
+
+        RepeatIterator operator++(int) noexcept{
+            return *this;
+        }
+
+    private:
+        const T* value_;
+    };
+
+    // Вставляет count элементов из first на позицию index
+    template <typename ForwardIt>
+    void InsertRange(size_t index, ForwardIt first, size_t count){
+        assert(index <= size_);
+        if(count == 0){
+            return;
+        }
+
+        if(size_ + count > data_.Capacity()){
+            Instrumentation::OnGrowth();
+            Memory new_data = AllocateMemory(std::max(size_ + count, NextCapacity()));
+            T* const inserted = new_data + index;
+            std::uninitialized_copy_n(first, count, inserted);
+            try {
+                FillNewData(new_data, 0, 0, index);
+            } catch(...){
+                std::destroy_n(inserted, count);
+                throw;
+            }
+            try {
+                FillNewData(new_data, index, index + count, size_ - index);
+            } catch(...){
+                std::destroy_n(new_data.GetAddress(), index + count);
+                throw;
+            }
+            DestroyOldData();
+            data_.Swap(new_data);
+            size_ += count;
+            return;
+        }
+
+        T* const pos = begin() + index;
+        T* const old_end = end();
+        const size_t elems_after = size_ - index;
+        if constexpr(is_trivially_relocatable_v<T>){
+            // Хвост сдвигается одним memmove, а при исключении возвращается на место
+            std::memmove(static_cast<void*>(pos + count), static_cast<const void*>(pos), elems_after * sizeof(T));
+            try {
+                std::uninitialized_copy_n(first, count, pos);
+            } catch(...){
+                std::memmove(static_cast<void*>(pos), static_cast<const void*>(pos + count), elems_after * sizeof(T));
+                throw;
+            }
+            size_ += count;
+        } else if(elems_after > count){
+            std::uninitialized_move_n(old_end - count, count, old_end);
+            size_ += count;
+            std::move_backward(pos, old_end - count, old_end);
+            std::copy_n(first, count, pos);
+        } else {
+            ForwardIt mid = std::next(first, elems_after);
+            std::uninitialized_copy_n(mid, count - elems_after, old_end);
+            size_ += count - elems_after;
+            try {
+                std::uninitialized_move_n(pos, elems_after, pos + count);
+            } catch(...){
+                std::destroy_n(old_end, count - elems_after);
+                size_ -= count - elems_after;
+                throw;
+            }
+            size_ += elems_after;
+            std::copy_n(first, elems_after, pos);
+        }
+    }
+
+    VECTOR_CONSTEXPR void FillNewData(Memory& new_data, size_t from, size_t to, size_t count){
+        if constexpr(is_trivially_relocatable_v<T>){
+            Instrumentation::OnRelocate(count);
+        } else if constexpr(std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>){
+            Instrumentation::OnMove(count);
         } else {
-            std::uninitialized_copy_n(data_.GetAddress() + from, count, new_data.GetAddress() + to); 
+            Instrumentation::OnCopy(count);
         }
+        UninitializedRelocateN(data_.GetAddress() + from, count, new_data.GetAddress() + to);
     }
 
-    void FillBehindIndex(RawMemory<T>& new_data, size_t index){
+    VECTOR_CONSTEXPR void FillBehindIndex(Memory& new_data, size_t index){
         try {
             FillNewData(new_data, 0, 0, index);
         } catch(...){
             new_data[index].~T();
+            throw;
         }
     }
 
-    void FillAfterIndex(RawMemory<T>& new_data, size_t index){
+    VECTOR_CONSTEXPR void FillAfterIndex(Memory& new_data, size_t index){
         try{
             FillNewData(new_data, index, index + 1, size_ - index);
         } catch(...){
             for(size_t i = 0; i <= index; ++i){
                 new_data[i].~T();
             }
+            throw;
         }
     }
 
-    RawMemory<T> data_;
+    // Уничтожает исходные элементы после переноса в новую память
+    VECTOR_CONSTEXPR void DestroyOldData() noexcept{
+        DestroyRelocatedN(data_.GetAddress(), size_);
+    }
+
+    template <typename... Args>
+    static constexpr bool IsSingleValue() noexcept {
+        return sizeof...(Args) == 1 && (std::is_same_v<std::decay_t<Args>, T> && ...);
+    }
+
+    VECTOR_CONSTEXPR bool IsElement(const T* ptr) const noexcept {
+        if(detail::IsConstantEvaluated()){
+            // Во время компиляции нельзя упорядочивать указатели на разные объекты
+            for(size_t i = 0; i < size_; ++i){
+                if(ptr == data_ + i){
+                    return true;
+                }
+            }
+            return false;
+        }
+        return !std::less<const T*>{}(ptr, data_.GetAddress()) && std::less<const T*>{}(ptr, data_ + size_);
+    }
+
+    // Сдвигает элементы [index, size_) на одну позицию вправо, не меняя size_.
+    // Позиция index остаётся занята перемещённым элементом. Требует index < size_:
+    // длина сдвига вычисляется один раз и проверяется, чтобы компилятор видел, что
+    // она положительна, и не предупреждал о memmove отрицательной длины
+    VECTOR_CONSTEXPR void ShiftRight(size_t index){
+        assert(index < size_);
+        const size_t count = size_ - index;
+        if(count == 0){
+            return;
+        }
+        T* const first = data_.GetAddress() + index;
+        detail::ConstructAt(first + count, std::move(first[count - 1]));
+        std::move_backward(first, first + count - 1, first + count);
+    }
+
+    // Вставка готового значения в середину без промежуточной копии: значение
+    // присваивается сразу на место, если оно не лежит в самом векторе.
+    // Если присваивание бросает исключение, сдвинутые элементы возвращаются назад
+    template <typename Value>
+    VECTOR_CONSTEXPR void InsertValue(size_t index, Value&& value){
+        if(IsElement(std::addressof(value))){
+            T elem(std::forward<Value>(value));
+            ShiftRight(index);
+            data_[index] = std::move(elem);
+            return;
+        }
+        ShiftRight(index);
+        try {
+            data_[index] = std::forward<Value>(value);
+        } catch(...){
+            std::move(begin() + index + 1, end() + 1, begin() + index);
+            std::destroy_at(end());
+            throw;
+        }
+    }
+
+    // Переносит первые count элементов в начало new_data порциями, распределёнными политикой
+    template <typename Policy>
+    void FillNewData(Memory& new_data, size_t count, const Policy& policy){
+        if constexpr(is_trivially_relocatable_v<T>){
+            Instrumentation::OnRelocate(count);
+        } else if constexpr(std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>){
+            Instrumentation::OnMove(count);
+        } else {
+            Instrumentation::OnCopy(count);
+        }
+        T* const from = data_.GetAddress();
+        T* const to = new_data.GetAddress();
+        policy.UninitializedFor(count, [from, to](size_t begin, size_t end) {
+            UninitializedRelocateN(from + begin, end - begin, to + begin);
+        }, [to](size_t begin, size_t end) {
+            std::destroy_n(to + begin, end - begin);
+        });
+    }
+
+    template <typename Policy>
+    void DestroyOldData(const Policy& policy){
+        T* const data = data_.GetAddress();
+        policy.For(size_, [data](size_t begin, size_t end) {
+            DestroyRelocatedN(data + begin, end - begin);
+        });
+    }
+
+    Memory data_;
     size_t size_ = 0;
-};
\ No newline at end of file
+};
+
+// Удаляет все элементы, удовлетворяющие pred, за один проход с сохранением порядка.
+// Возвращает количество удалённых элементов
+template <typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation, typename Predicate>
+size_t EraseIf(Vector<T, Allocator, GrowthPolicy, Instrumentation>& vector, Predicate pred){
+    const auto new_end = std::remove_if(vector.begin(), vector.end(), pred);
+    const size_t removed = vector.end() - new_end;
+    vector.Erase(new_end, vector.cend());
+    return removed;
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include "simd.h"
+#include "vector.h"
+#include "vector_view.h"
+
+#include <type_traits>
+#include <utility>
+
+// Алгоритмы над элементами Vector и VectorView. Для арифметических типов используются
+// векторизованные ядра из simd.h, для остальных - алгоритмы стандартной библиотеки.
+// Перегрузки для Vector обрабатывают весь вектор, для части вектора передаётся его Subspan
+
+template <typename T>
+T* Find(VectorView<T> view, const std::remove_const_t<T>& value){
+    return view.begin() + simd::Find(view.Data(), view.Size(), value);
+}
+
+template <typename T>
+bool Contains(VectorView<T> view, const std::remove_const_t<T>& value){
+    return simd::Contains(view.Data(), view.Size(), value);
+}
+
+template <typename T>
+size_t Count(VectorView<T> view, const std::remove_const_t<T>& value){
+    return simd::Count(view.Data(), view.Size(), value);
+}
+
+template <typename T>
+void Fill(VectorView<T> view, const T& value){
+    static_assert(!std::is_const_v<T>, "Fill requires a mutable view");
+    simd::Fill(view.Data(), view.Size(), value);
+}
+
+// Минимальный и максимальный элементы непустого диапазона
+template <typename T>
+std::pair<std::remove_const_t<T>, std::remove_const_t<T>> MinMax(VectorView<T> view){
+    return simd::MinMax(view.Data(), view.Size());
+}
+
+template <typename T>
+std::remove_const_t<T> Sum(VectorView<T> view){
+    return simd::Sum(view.Data(), view.Size());
+}
+
+template <typename T, typename U>
+bool Equal(VectorView<T> lhs, VectorView<U> rhs){
+    static_assert(std::is_same_v<std::remove_const_t<T>, std::remove_const_t<U>>, "Equal requires views of the same type");
+    return lhs.Size() == rhs.Size() && simd::Equal(lhs.Data(), rhs.Data(), lhs.Size());
+}
+
+template <typename T, typename... Params>
+typename Vector<T, Params...>::const_iterator Find(const Vector<T, Params...>& vector, const T& value){
+    return Find(VectorView(vector), value);
+}
+
+template <typename T, typename... Params>
+bool Contains(const Vector<T, Params...>& vector, const T& value){
+    return Contains(VectorView(vector), value);
+}
+
+template <typename T, typename... Params>
+size_t Count(const Vector<T, Params...>& vector, const T& value){
+    return Count(VectorView(vector), value);
+}
+
+template <typename T, typename... Params>
+void Fill(Vector<T, Params...>& vector, const T& value){
+    Fill(VectorView(vector), value);
+}
+
+// Минимальный и максимальный элементы непустого вектора
+template <typename T, typename... Params>
+std::pair<T, T> MinMax(const Vector<T, Params...>& vector){
+    return MinMax(VectorView(vector));
+}
+
+template <typename T, typename... Params>
+T Sum(const Vector<T, Params...>& vector){
+    return Sum(VectorView(vector));
+}
+
+template <typename T, typename... Params>
+bool operator==(const Vector<T, Params...>& lhs, const Vector<T, Params...>& rhs){
+    return Equal(VectorView(lhs), VectorView(rhs));
+}
+
+template <typename T, typename... Params>
+bool operator!=(const Vector<T, Params...>& lhs, const Vector<T, Params...>& rhs){
+    return !(lhs == rhs);
+}
@@ -0,0 +1,141 @@
+#pragma once
+#include "vector.h"
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+// Невладеющее представление непрерывного диапазона: указатель и длина.
+// Копируется побайтово и передаётся по значению вместо const Vector<T>&,
+// а Subspan выделяет часть диапазона без выделения памяти и копирования.
+// VectorView<const T> только читает элементы, VectorView<T> может их изменять.
+// Представление действительно, пока не перевыделен или не разрушен исходный контейнер
+template <typename T>
+class VectorView {
+    // Из U* в T* допускаются только квалификационные преобразования (например, int* в const int*)
+    template <typename U>
+    using RequireCompatible = std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>;
+
+public:
+    using value_type = std::remove_cv_t<T>;
+    using iterator = T*;
+    using const_iterator = T*;
+
+    static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+    constexpr VectorView() noexcept = default;
+
+    constexpr VectorView(T* data, size_t size) noexcept
+    : data_(data), size_(size){
+    }
+
+    template <size_t N>
+    constexpr VectorView(T (&array)[N]) noexcept
+    : VectorView(array, N){
+    }
+
+    template <typename U, typename... Params, typename = RequireCompatible<U>>
+    constexpr VectorView(Vector<U, Params...>& vector) noexcept
+    : VectorView(vector.begin(), vector.Size()){
+    }
+
+    template <typename U, typename... Params, typename = RequireCompatible<const U>>
+    constexpr VectorView(const Vector<U, Params...>& vector) noexcept
+    : VectorView(vector.begin(), vector.Size()){
+    }
+
+    template <typename U, typename Alloc, typename = RequireCompatible<U>>
+    constexpr VectorView(std::vector<U, Alloc>& vector) noexcept
+    : VectorView(vector.data(), vector.size()){
+    }
+
+    template <typename U, typename Alloc, typename = RequireCompatible<const U>>
+    constexpr VectorView(const std::vector<U, Alloc>& vector) noexcept
+    : VectorView(vector.data(), vector.size()){
+    }
+
+    // VectorView<T> приводится к VectorView<const T>
+    template <typename U, typename = RequireCompatible<U>>
+    constexpr VectorView(VectorView<U> other) noexcept
+    : VectorView(other.Data(), other.Size()){
+    }
+
+    constexpr T* Data() const noexcept {
+        return data_;
+    }
+
+    constexpr size_t Size() const noexcept {
+        return size_;
+    }
+
+    constexpr bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    constexpr T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    constexpr T& Front() const noexcept {
+        assert(size_ != 0);
+        return data_[0];
+    }
+
+    constexpr T& Back() const noexcept {
+        assert(size_ != 0);
+        return data_[size_ - 1];
+    }
+
+    // count элементов начиная с offset; NPOS - до конца диапазона
+    constexpr VectorView Subspan(size_t offset, size_t count = NPOS) const noexcept {
+        assert(offset <= size_);
+        assert(count == NPOS || count <= size_ - offset);
+        return {data_ + offset, count == NPOS ? size_ - offset : count};
+    }
+
+    constexpr VectorView First(size_t count) const noexcept {
+        return Subspan(0, count);
+    }
+
+    constexpr VectorView Last(size_t count) const noexcept {
+        assert(count <= size_);
+        return Subspan(size_ - count, count);
+    }
+
+    constexpr iterator begin() const noexcept {
+        return data_;
+    }
+
+    constexpr iterator end() const noexcept {
+        return data_ + size_;
+    }
+
+    constexpr const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    constexpr const_iterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+template <typename T, size_t N>
+VectorView(T (&)[N]) -> VectorView<T>;
+
+template <typename T, typename... Params>
+VectorView(Vector<T, Params...>&) -> VectorView<T>;
+
+template <typename T, typename... Params>
+VectorView(const Vector<T, Params...>&) -> VectorView<const T>;
+
+template <typename T, typename Alloc>
+VectorView(std::vector<T, Alloc>&) -> VectorView<T>;
+
+template <typename T, typename Alloc>
+VectorView(const std::vector<T, Alloc>&) -> VectorView<const T>;